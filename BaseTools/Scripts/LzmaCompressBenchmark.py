@@ -0,0 +1,113 @@
+# @file LzmaCompressBenchmark.py
+# This script compares the single threaded and multithreaded (--mt) LZMA
+# compression of LzmaCompress on the given payloads, typically the FV files
+# in the FV folder of a platform build output.
+#
+#  SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+#
+# Import Modules
+#
+from __future__ import print_function
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+__prog__        = 'LzmaCompressBenchmark'
+__version__     = '%s Version %s' % (__prog__, '0.10 ')
+__description__ = 'Compare speed and ratio of LzmaCompress with and without --mt.\n'
+
+DEFAULT_EXT_LIST = ['.fv', '.Fv', '.fd', '.ffs', '.efi', '.raw']
+
+def Compress(Tool, Options, Input, Output, Count):
+    Cmd = [Tool, '-e', '-q', '-o', Output] + Options + [Input]
+    Best = None
+    for Index in range(Count):
+        Start = time.time()
+        subprocess.check_call(Cmd)
+        Elapsed = time.time() - Start
+        if Best is None or Elapsed < Best:
+            Best = Elapsed
+    with open(Output, 'rb') as Fd:
+        Content = Fd.read()
+    return Best, Content
+
+def GetFiles(Path):
+    if os.path.isfile(Path):
+        return [Path]
+    FileList = []
+    for DirPath, DirNames, FileNames in os.walk(Path):
+        for FileName in FileNames:
+            if os.path.splitext(FileName)[1] in DEFAULT_EXT_LIST:
+                FileList.append(os.path.join(DirPath, FileName))
+    return sorted(FileList)
+
+def Benchmark(Args):
+    Options = []
+    if Args.F86:
+        Options.append('--f86')
+    if Args.Algo is not None:
+        Options += ['-a', str(Args.Algo)]
+
+    FileList = []
+    for Path in Args.Path:
+        if not os.path.exists(Path):
+            print("not exists path: {0}".format(Path))
+            return 1
+        FileList += GetFiles(Path)
+    if not FileList:
+        print("no payload found")
+        return 1
+
+    Result = 0
+    Total = [0, 0, 0.0, 0.0]
+    print('%-40s %10s %10s %7s %9s %9s %7s' % ('File', 'Size', 'Packed', 'Ratio', 'ST (s)', 'MT (s)', 'Speedup'))
+    TempDir = tempfile.mkdtemp()
+    try:
+        for File in FileList:
+            Size = os.path.getsize(File)
+            if Size == 0:
+                continue
+            StTime, StData = Compress(Args.Tool, Options, File, os.path.join(TempDir, 'st.lz'), Args.Count)
+            MtTime, MtData = Compress(Args.Tool, Options + ['--mt'], File, os.path.join(TempDir, 'mt.lz'), Args.Count)
+            if StData != MtData:
+                print('%s: multithreaded output is different' % File)
+                Result = 1
+            print('%-40s %10d %10d %6.2f%% %9.3f %9.3f %6.2fx' % (
+                  os.path.basename(File)[-40:], Size, len(StData), 100.0 * len(StData) / Size,
+                  StTime, MtTime, StTime / MtTime if MtTime else 0.0))
+            Total[0] += Size
+            Total[1] += len(StData)
+            Total[2] += StTime
+            Total[3] += MtTime
+    finally:
+        for FileName in os.listdir(TempDir):
+            os.remove(os.path.join(TempDir, FileName))
+        os.rmdir(TempDir)
+
+    if Total[0]:
+        print('%-40s %10d %10d %6.2f%% %9.3f %9.3f %6.2fx' % (
+              'Total', Total[0], Total[1], 100.0 * Total[1] / Total[0],
+              Total[2], Total[3], Total[2] / Total[3] if Total[3] else 0.0))
+    return Result
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(prog=__prog__, description=__description__, conflict_handler = 'resolve')
+
+    parser.add_argument('Path', nargs='+',
+                        help='the payload to be compressed. It could be directory or file path.')
+    parser.add_argument('--version', action='version', version=__version__)
+    parser.add_argument('--tool', dest='Tool', default='LzmaCompress',
+                        help='the LzmaCompress executable, default is the one in PATH.')
+    parser.add_argument('-n', '--count', dest='Count', type=int, default=3,
+                        help='compress each payload N times and use the best time, default is 3.')
+    parser.add_argument('--f86', dest='F86', action='store_true',
+                        help='enable converter for x86 code')
+    parser.add_argument('-a', dest='Algo', type=int, choices=[0, 1],
+                        help='set compression mode 0 = fast, 1 = normal')
+    args = parser.parse_args()
+    sys.exit(Benchmark(args))
@@ -136,6 +136,9 @@ Returns:
   fprintf (stdout, "  --capheadsize HeadSize\n\
                         HeadSize is one HEX or DEC format value\n\
                         HeadSize is required by Capsule Image.\n");
+  fprintf (stdout, "  --threads ThreadCount Read FFS files and check their checksums on up to\n\
+                        ThreadCount threads. The files are still placed\n\
+                        in order, so the FV image does not change.\n");
   fprintf (stdout, "  -c, --capsule         Create Capsule Image.\n");
   fprintf (stdout, "  -p, --dump            Dump Capsule Image header.\n");
   fprintf (stdout, "  -v, --verbose         Turn on verbose output with informational messages.\n");
@@ -410,6 +413,22 @@ Returns:
       continue;
     }
 
+    if (stricmp (argv[0], "--threads") == 0) {
+      //
+      // Get the number of FFS preload threads
+      //
+      Status = AsciiStringToUint64 (argv[1], FALSE, &TempNumber);
+      if (EFI_ERROR (Status) || TempNumber > MAX_NUMBER_OF_FV_THREADS) {
+        Error (NULL, 0, 1003, "Invalid option value", "%s = %s", argv[0], argv[1]);
+        return STATUS_ERROR;
+      }
+      mFvThreadCount = (UINT32) TempNumber;
+      DebugMsg (NULL, 0, 9, "FFS preload threads", "%u", (unsigned) mFvThreadCount);
+      argc -= 2;
+      argv += 2;
+      continue;
+    }
+
     if (stricmp (argv[0], "--capflag") == 0) {
       //
       // Get Capsule Header
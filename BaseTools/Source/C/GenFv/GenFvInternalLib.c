@@ -20,6 +20,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #endif
 #ifdef __GNUC__
 #include <sys/stat.h>
+#include <sys/time.h>
+#include <pthread.h>
 #endif
 #include <string.h>
 #ifndef __GNUC__
@@ -163,6 +165,22 @@ FV_INFO                     mFvDataInfo;
 CAP_INFO                    mCapDataInfo;
 BOOLEAN                     mIsLargeFfs = FALSE;
 
+//
+// Number of threads that preload FFS files. 0 or 1 keeps the serial flow.
+//
+UINT32                      mFvThreadCount = 0;
+FFS_PRELOAD_INFO            *mFfsPreload   = NULL;
+
+//
+// Work assigned to one preload thread
+//
+typedef struct {
+  FV_INFO                   *FvInfo;
+  UINTN                     FileCount;
+  UINTN                     FirstIndex;
+  UINTN                     Stride;
+} FFS_PRELOAD_CONTEXT;
+
 EFI_PHYSICAL_ADDRESS mFvBaseAddress[0x10];
 UINT32               mFvBaseAddressNumber = 0;
 
@@ -1158,6 +1176,341 @@ Returns:
   return TRUE;
 }
 
+UINT64
+GetTimeInMilliseconds (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Get a monotonic-enough wall clock time stamp for stage timing.
+
+Arguments:
+
+  None
+
+Returns:
+
+  The current time in milliseconds.
+
+--*/
+{
+#ifdef __GNUC__
+  struct timeval  Time;
+
+  gettimeofday (&Time, NULL);
+  return (UINT64) Time.tv_sec * 1000 + Time.tv_usec / 1000;
+#else
+  return GetTickCount64 ();
+#endif
+}
+
+EFI_STATUS
+ReadFfsFileImage (
+  IN  CHAR8                   *FileName,
+  OUT UINT8                   **FileBuffer,
+  OUT UINTN                   *FileSize
+  )
+/*++
+
+Routine Description:
+
+  Read an FFS file into a newly allocated buffer. No message is reported, so
+  this function may be called from preload threads.
+
+Arguments:
+
+  FileName      The name of the FFS file.
+  FileBuffer    The buffer holding the file contents, to be freed by caller.
+  FileSize      The size of the file in bytes.
+
+Returns:
+
+  EFI_SUCCESS              The file was read.
+  EFI_NOT_FOUND            The file could not be opened.
+  EFI_OUT_OF_RESOURCES     The buffer could not be allocated.
+  EFI_ABORTED              The file could not be read.
+
+--*/
+{
+  FILE                  *NewFile;
+  UINTN                 NumBytesRead;
+
+  *FileBuffer = NULL;
+  *FileSize   = 0;
+
+  NewFile = fopen (LongFilePath (FileName), "rb");
+  if (NewFile == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  *FileSize = _filelength (fileno (NewFile));
+
+  *FileBuffer = malloc (*FileSize);
+  if (*FileBuffer == NULL) {
+    fclose (NewFile);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  NumBytesRead = fread (*FileBuffer, sizeof (UINT8), *FileSize, NewFile);
+  fclose (NewFile);
+
+  if (NumBytesRead != sizeof (UINT8) * *FileSize) {
+    free (*FileBuffer);
+    *FileBuffer = NULL;
+    return EFI_ABORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+BOOLEAN
+IsFfsFileChecksumValid (
+  IN EFI_FFS_FILE_HEADER      *FfsFile,
+  IN UINTN                    FileSize
+  )
+/*++
+
+Routine Description:
+
+  Check the header and data checksums of an FFS file the same way
+  VerifyFfsFile() does, without reporting errors or requiring the FV library
+  to be initialized. An erased header never passes these checks.
+
+Arguments:
+
+  FfsFile       Pointer to the FFS file contents.
+  FileSize      The size of the buffer holding the FFS file.
+
+Returns:
+
+  TRUE          Both checksums are valid.
+  FALSE         A checksum is invalid or the file is truncated.
+
+--*/
+{
+  UINT32                FfsHeaderSize;
+  UINT32                FfsFileLength;
+  UINT8                 Checksum;
+
+  if (FileSize < sizeof (EFI_FFS_FILE_HEADER)) {
+    return FALSE;
+  }
+  FfsHeaderSize = GetFfsHeaderLength (FfsFile);
+  if (FileSize < FfsHeaderSize) {
+    return FALSE;
+  }
+  FfsFileLength = GetFfsFileLength (FfsFile);
+  if (FfsFileLength < FfsHeaderSize || FfsFileLength > FileSize) {
+    return FALSE;
+  }
+
+  //
+  // The header checksum excludes the State and File checksum fields.
+  //
+  Checksum = CalculateSum8 ((UINT8 *) FfsFile, FfsHeaderSize);
+  Checksum = (UINT8) (Checksum - FfsFile->State - FfsFile->IntegrityCheck.Checksum.File);
+  if (Checksum != 0) {
+    return FALSE;
+  }
+
+  if ((FfsFile->Attributes & FFS_ATTRIB_CHECKSUM) != 0) {
+    Checksum = CalculateSum8 ((UINT8 *) FfsFile + FfsHeaderSize, FfsFileLength - FfsHeaderSize);
+    Checksum = (UINT8) (Checksum + FfsFile->IntegrityCheck.Checksum.File);
+    return (BOOLEAN) (Checksum == 0);
+  }
+
+  return (BOOLEAN) (FfsFile->IntegrityCheck.Checksum.File == FFS_FIXED_CHECKSUM);
+}
+
+VOID
+PreloadFfsFileRange (
+  IN FFS_PRELOAD_CONTEXT      *Context
+  )
+/*++
+
+Routine Description:
+
+  Read and check every Stride-th FFS file starting at FirstIndex. Results go
+  to the file's own slot in mFfsPreload, so threads never share state.
+
+Arguments:
+
+  Context       The range of files to preload.
+
+Returns:
+
+  None
+
+--*/
+{
+  UINTN                 Index;
+  FFS_PRELOAD_INFO      *Preload;
+
+  for (Index = Context->FirstIndex; Index < Context->FileCount; Index += Context->Stride) {
+    Preload         = &mFfsPreload[Index];
+    Preload->Status = ReadFfsFileImage (
+                        Context->FvInfo->FvFiles[Index],
+                        &Preload->FileBuffer,
+                        &Preload->FileSize
+                        );
+    if (!EFI_ERROR (Preload->Status) && Context->FvInfo->IsPiFvImage) {
+      Preload->ChecksumVerified = IsFfsFileChecksumValid (
+                                    (EFI_FFS_FILE_HEADER *) Preload->FileBuffer,
+                                    Preload->FileSize
+                                    );
+    }
+  }
+}
+
+#ifdef __GNUC__
+VOID *
+PreloadFfsFileThread (
+  IN VOID                     *Context
+  )
+{
+  PreloadFfsFileRange ((FFS_PRELOAD_CONTEXT *) Context);
+  return NULL;
+}
+#else
+DWORD
+WINAPI
+PreloadFfsFileThread (
+  IN LPVOID                   Context
+  )
+{
+  PreloadFfsFileRange ((FFS_PRELOAD_CONTEXT *) Context);
+  return 0;
+}
+#endif
+
+EFI_STATUS
+PreloadFfsFiles (
+  IN FV_INFO                  *FvInfo
+  )
+/*++
+
+Routine Description:
+
+  Read all FFS files of the FV and check their checksums on mFvThreadCount
+  threads. Files are placed into the FV afterwards, in their original order,
+  so the output does not depend on the thread count. A file that fails here
+  is read again by AddFile(), which reports the error.
+
+Arguments:
+
+  FvInfo        Pointer to information about the FV.
+
+Returns:
+
+  EFI_SUCCESS              The preload completed, or was skipped.
+  EFI_OUT_OF_RESOURCES     The preload table could not be allocated.
+
+--*/
+{
+  UINTN                 FileCount;
+  UINT32                ThreadCount;
+  UINT32                Index;
+  FFS_PRELOAD_CONTEXT   Context[MAX_NUMBER_OF_FV_THREADS];
+#ifdef __GNUC__
+  pthread_t             Thread[MAX_NUMBER_OF_FV_THREADS];
+#else
+  HANDLE                Thread[MAX_NUMBER_OF_FV_THREADS];
+#endif
+  BOOLEAN               ThreadStarted[MAX_NUMBER_OF_FV_THREADS];
+
+  for (FileCount = 0; FvInfo->FvFiles[FileCount][0] != 0; FileCount++);
+
+  ThreadCount = mFvThreadCount;
+  if (ThreadCount > MAX_NUMBER_OF_FV_THREADS) {
+    ThreadCount = MAX_NUMBER_OF_FV_THREADS;
+  }
+  if (ThreadCount > FileCount) {
+    ThreadCount = (UINT32) FileCount;
+  }
+  if (ThreadCount <= 1) {
+    return EFI_SUCCESS;
+  }
+
+  mFfsPreload = calloc (FileCount, sizeof (FFS_PRELOAD_INFO));
+  if (mFfsPreload == NULL) {
+    Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+    return EFI_OUT_OF_RESOURCES;
+  }
+  for (Index = 0; Index < FileCount; Index++) {
+    mFfsPreload[Index].Status = EFI_NOT_STARTED;
+  }
+
+  for (Index = 0; Index < ThreadCount; Index++) {
+    Context[Index].FvInfo     = FvInfo;
+    Context[Index].FileCount  = FileCount;
+    Context[Index].FirstIndex = Index;
+    Context[Index].Stride     = ThreadCount;
+#ifdef __GNUC__
+    ThreadStarted[Index] = (BOOLEAN) (pthread_create (&Thread[Index], NULL, PreloadFfsFileThread, &Context[Index]) == 0);
+#else
+    Thread[Index] = CreateThread (NULL, 0, PreloadFfsFileThread, &Context[Index], 0, NULL);
+    ThreadStarted[Index] = (BOOLEAN) (Thread[Index] != NULL);
+#endif
+    if (!ThreadStarted[Index]) {
+      //
+      // Do the work of a thread that could not be created in place.
+      //
+      PreloadFfsFileRange (&Context[Index]);
+    }
+  }
+
+  for (Index = 0; Index < ThreadCount; Index++) {
+    if (ThreadStarted[Index]) {
+#ifdef __GNUC__
+      pthread_join (Thread[Index], NULL);
+#else
+      WaitForSingleObject (Thread[Index], INFINITE);
+      CloseHandle (Thread[Index]);
+#endif
+    }
+  }
+
+  VerboseMsg ("preloaded %u FFS files on %u threads", (unsigned) FileCount, (unsigned) ThreadCount);
+  return EFI_SUCCESS;
+}
+
+VOID
+FreePreloadedFfsFiles (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Free the FFS file buffers that were preloaded but not consumed by AddFile().
+
+Arguments:
+
+  None
+
+Returns:
+
+  None
+
+--*/
+{
+  UINTN                 Index;
+
+  if (mFfsPreload == NULL) {
+    return;
+  }
+
+  for (Index = 0; mFvDataInfo.FvFiles[Index][0] != 0; Index++) {
+    if (mFfsPreload[Index].FileBuffer != NULL) {
+      free (mFfsPreload[Index].FileBuffer);
+    }
+  }
+  free (mFfsPreload);
+  mFfsPreload = NULL;
+}
+
 EFI_STATUS
 AddFile (
   IN OUT MEMORY_FILE          *FvImage,
@@ -1194,10 +1547,9 @@ Returns:
 
 --*/
 {
-  FILE                  *NewFile;
   UINTN                 FileSize;
   UINT8                 *FileBuffer;
-  UINTN                 NumBytesRead;
+  BOOLEAN               ChecksumVerified;
   UINT32                CurrentFileAlignment;
   EFI_STATUS            Status;
   UINTN                 Index1;
@@ -1212,42 +1564,27 @@ Returns:
   }
 
   //
-  // Read the file to add
+  // Take the preloaded file if there is one, otherwise read the file to add.
+  // From this point on we will just use the buffer read.
   //
-  NewFile = fopen (LongFilePath (FvInfo->FvFiles[Index]), "rb");
+  ChecksumVerified = FALSE;
+  if (mFfsPreload != NULL && !EFI_ERROR (mFfsPreload[Index].Status)) {
+    FileBuffer       = mFfsPreload[Index].FileBuffer;
+    FileSize         = mFfsPreload[Index].FileSize;
+    ChecksumVerified = mFfsPreload[Index].ChecksumVerified;
+    mFfsPreload[Index].FileBuffer = NULL;
+    Status           = EFI_SUCCESS;
+  } else {
+    Status = ReadFfsFileImage (FvInfo->FvFiles[Index], &FileBuffer, &FileSize);
+  }
 
-  if (NewFile == NULL) {
+  if (Status == EFI_NOT_FOUND) {
     Error (NULL, 0, 0001, "Error opening file", FvInfo->FvFiles[Index]);
     return EFI_ABORTED;
-  }
-
-  //
-  // Get the file size
-  //
-  FileSize = _filelength (fileno (NewFile));
-
-  //
-  // Read the file into a buffer
-  //
-  FileBuffer = malloc (FileSize);
-  if (FileBuffer == NULL) {
-    fclose (NewFile);
+  } else if (Status == EFI_OUT_OF_RESOURCES) {
     Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
     return EFI_OUT_OF_RESOURCES;
-  }
-
-  NumBytesRead = fread (FileBuffer, sizeof (UINT8), FileSize, NewFile);
-
-  //
-  // Done with the file, from this point on we will just use the buffer read.
-  //
-  fclose (NewFile);
-
-  //
-  // Verify read successful
-  //
-  if (NumBytesRead != sizeof (UINT8) * FileSize) {
-    free  (FileBuffer);
+  } else if (EFI_ERROR (Status)) {
     Error (NULL, 0, 0004, "Error reading file", FvInfo->FvFiles[Index]);
     return EFI_ABORTED;
   }
@@ -1266,13 +1603,15 @@ Returns:
   }
 
   //
-  // Verify Ffs file
+  // Verify Ffs file, unless its checksums were already checked by preload
   //
-  Status = VerifyFfsFile ((EFI_FFS_FILE_HEADER *)FileBuffer);
-  if (EFI_ERROR (Status)) {
-    free (FileBuffer);
-    Error (NULL, 0, 3000, "Invalid", "%s is not a valid FFS file.", FvInfo->FvFiles[Index]);
-    return EFI_INVALID_PARAMETER;
+  if (!ChecksumVerified) {
+    Status = VerifyFfsFile ((EFI_FFS_FILE_HEADER *)FileBuffer);
+    if (EFI_ERROR (Status)) {
+      free (FileBuffer);
+      Error (NULL, 0, 3000, "Invalid", "%s is not a valid FFS file.", FvInfo->FvFiles[Index]);
+      return EFI_INVALID_PARAMETER;
+    }
   }
 
   //
@@ -2538,6 +2877,7 @@ Returns:
   UINTN                           FileSize;
   CHAR8                           *FvReportName;
   FILE                            *FvReportFile;
+  UINT64                          StageStartTime;
 
   FvBufferHeader = NULL;
   FvFile         = NULL;
@@ -2733,15 +3073,27 @@ Returns:
   strcpy (FvReportName, FvFileName);
   strcat (FvReportName, ".txt");
 
+  //
+  // Read and check the FFS files on worker threads if requested.
+  //
+  StageStartTime = GetTimeInMilliseconds ();
+  Status = PreloadFfsFiles (&mFvDataInfo);
+  if (EFI_ERROR (Status)) {
+    goto Finish;
+  }
+  VerboseMsg ("FFS preload stage took %u ms", (unsigned) (GetTimeInMilliseconds () - StageStartTime));
+
   //
   // Calculate the FV size and Update Fv Size based on the actual FFS files.
   // And Update mFvDataInfo data.
   //
+  StageStartTime = GetTimeInMilliseconds ();
   Status = CalculateFvSize (&mFvDataInfo);
   if (EFI_ERROR (Status)) {
     goto Finish;
   }
   VerboseMsg ("the generated FV image size is %u bytes", (unsigned) mFvDataInfo.Size);
+  VerboseMsg ("FV size stage took %u ms", (unsigned) (GetTimeInMilliseconds () - StageStartTime));
 
   //
   // support fv image and empty fv image
@@ -2900,6 +3252,7 @@ Returns:
   //
   // Add files to FV
   //
+  StageStartTime = GetTimeInMilliseconds ();
   for (Index = 0; mFvDataInfo.FvFiles[Index][0] != 0; Index++) {
     //
     // Add the file
@@ -2913,6 +3266,7 @@ Returns:
       goto Finish;
     }
   }
+  VerboseMsg ("FFS placement stage took %u ms", (unsigned) (GetTimeInMilliseconds () - StageStartTime));
 
   //
   // If there is a VTF file, some special actions need to occur.
@@ -3005,6 +3359,7 @@ WriteFile:
   //
   // Write fv file
   //
+  StageStartTime = GetTimeInMilliseconds ();
   FvFile = fopen (LongFilePath (FvFileName), "wb");
   if (FvFile == NULL) {
     Error (NULL, 0, 0001, "Error opening file", FvFileName);
@@ -3017,8 +3372,11 @@ WriteFile:
     Status = EFI_ABORTED;
     goto Finish;
   }
+  VerboseMsg ("FV write stage took %u ms", (unsigned) (GetTimeInMilliseconds () - StageStartTime));
 
 Finish:
+  FreePreloadedFfsFiles ();
+
   if (FvBufferHeader != NULL) {
     free (FvBufferHeader);
   }
@@ -3201,33 +3559,43 @@ Returns:
   // Accumulate every FFS file size.
   //
   for (Index = 0; FvInfoPtr->FvFiles[Index][0] != 0; Index++) {
-    //
-    // Open FFS file
-    //
-    fpin = NULL;
-    fpin = fopen (LongFilePath (FvInfoPtr->FvFiles[Index]), "rb");
-    if (fpin == NULL) {
-      Error (NULL, 0, 0001, "Error opening file", FvInfoPtr->FvFiles[Index]);
-      return EFI_ABORTED;
+    if (mFfsPreload != NULL && !EFI_ERROR (mFfsPreload[Index].Status) &&
+        mFfsPreload[Index].FileSize >= sizeof (EFI_FFS_FILE_HEADER)) {
+      //
+      // Use the preloaded file instead of opening it again
+      //
+      FfsFileSize = mFfsPreload[Index].FileSize;
+      memcpy (&FfsHeader, mFfsPreload[Index].FileBuffer, sizeof (EFI_FFS_FILE_HEADER));
+    } else {
+      //
+      // Open FFS file
+      //
+      fpin = NULL;
+      fpin = fopen (LongFilePath (FvInfoPtr->FvFiles[Index]), "rb");
+      if (fpin == NULL) {
+        Error (NULL, 0, 0001, "Error opening file", FvInfoPtr->FvFiles[Index]);
+        return EFI_ABORTED;
+      }
+      //
+      // Get the file size
+      //
+      FfsFileSize = _filelength (fileno (fpin));
+      //
+      // Read Ffs File header
+      //
+      fread (&FfsHeader, sizeof (UINT8), sizeof (EFI_FFS_FILE_HEADER), fpin);
+      //
+      // close file
+      //
+      fclose (fpin);
     }
-    //
-    // Get the file size
-    //
-    FfsFileSize = _filelength (fileno (fpin));
+
     if (FfsFileSize >= MAX_FFS_SIZE) {
       FfsHeaderSize = sizeof(EFI_FFS_FILE_HEADER2);
       mIsLargeFfs = TRUE;
     } else {
       FfsHeaderSize = sizeof(EFI_FFS_FILE_HEADER);
     }
-    //
-    // Read Ffs File header
-    //
-    fread (&FfsHeader, sizeof (UINT8), sizeof (EFI_FFS_FILE_HEADER), fpin);
-    //
-    // close file
-    //
-    fclose (fpin);
 
     if (FvInfoPtr->IsPiFvImage) {
         //
@@ -223,6 +223,21 @@ typedef struct {
   CHAR8                   CapFiles[MAX_NUMBER_OF_FILES_IN_CAP][MAX_LONG_FILE_PATH];
 } CAP_INFO;
 
+//
+// FFS file read and checked ahead of placement into the FV
+//
+typedef struct {
+  UINT8                   *FileBuffer;
+  UINTN                   FileSize;
+  EFI_STATUS              Status;
+  BOOLEAN                 ChecksumVerified;
+} FFS_PRELOAD_INFO;
+
+//
+// Maximum number of threads used to preload FFS files
+//
+#define MAX_NUMBER_OF_FV_THREADS  64
+
 #pragma pack(1)
 
 typedef struct {
@@ -242,6 +257,7 @@ extern EFI_GUID   mEfiFirmwareFileSystem2Guid;
 extern EFI_GUID   mEfiFirmwareFileSystem3Guid;
 extern UINT32     mFvTotalSize;
 extern UINT32     mFvTakenSize;
+extern UINT32     mFvThreadCount;
 
 extern EFI_PHYSICAL_ADDRESS mFvBaseAddress[];
 extern UINT32               mFvBaseAddressNumber;
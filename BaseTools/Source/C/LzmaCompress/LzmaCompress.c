@@ -41,6 +41,7 @@ const char *kInvalidParamValMessage = "Invalid parameter value";
 
 static Bool mQuietMode = False;
 static CONVERTER_TYPE mConType = NoConverter;
+static int mNumThreads = 1;
 
 UINT64 mDictionarySize = 28;
 UINT64 mCompressionMode = 2;
@@ -60,6 +61,7 @@ void PrintHelp(char *buffer)
              "  -d: decode file\n"
              "  -o FileName, --output FileName: specify the output filename\n"
              "  --f86: enable converter for x86 code\n"
+             "  --mt: use multithreaded match finder, the output is the same\n"
              "  -v, --verbose: increase output messages\n"
              "  -q, --quiet: reduce output messages\n"
              "  --debug [0-9]: set debug level\n"
@@ -272,6 +274,8 @@ int main2(int numArgs, const char *args[], char *rs)
       modeWasSet = True;
     } else if (strcmp(args[param], "--f86") == 0) {
       mConType = X86Converter;
+    } else if (strcmp(args[param], "--mt") == 0) {
+      mNumThreads = 2;
     } else if (strcmp(args[param], "-o") == 0 ||
                strcmp(args[param], "--output") == 0) {
       if (numArgs < (param + 2)) {
@@ -361,6 +365,11 @@ int main2(int numArgs, const char *args[], char *rs)
 
   if (encodeMode)
   {
+    //
+    // The match finder runs in its own thread with --mt, which only applies to
+    // the binary tree (normal) mode. The compressed data is identical.
+    //
+    props.numThreads = mNumThreads;
     if (!mQuietMode) {
       printf("Encoding\n");
     }
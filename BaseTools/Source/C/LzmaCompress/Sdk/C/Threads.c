@@ -3,12 +3,22 @@
 
 #include "Precomp.h"
 
+#ifdef _WIN32
+
 #ifndef UNDER_CE
 #include <process.h>
 #endif
 
+#else
+
+#include <errno.h>
+
+#endif
+
 #include "Threads.h"
 
+#ifdef _WIN32
+
 static WRes GetError()
 {
   DWORD res = GetLastError();
@@ -93,3 +103,163 @@ WRes CriticalSection_Init(CCriticalSection *p)
   #endif
   return 0;
 }
+
+#else
+
+/* POSIX threads port for non-Windows hosts */
+
+static void *Thread_Start(void *param)
+{
+  CThread *p = (CThread *)param;
+  p->_func(p->_param);
+  return NULL;
+}
+
+WRes Thread_Create(CThread *p, THREAD_FUNC_TYPE func, void *param)
+{
+  int ret;
+  p->_func = func;
+  p->_param = param;
+  ret = pthread_create(&p->_tid, NULL, Thread_Start, p);
+  if (ret != 0)
+    return ret;
+  p->_created = 1;
+  return 0;
+}
+
+WRes Thread_Wait(CThread *p)
+{
+  int ret;
+  if (!p->_created)
+    return EINVAL;
+  ret = pthread_join(p->_tid, NULL);
+  p->_created = 0;
+  return ret;
+}
+
+WRes Thread_Close(CThread *p)
+{
+  if (!p->_created)
+    return 0;
+  p->_created = 0;
+  return pthread_detach(p->_tid);
+}
+
+static WRes Event_Create(CEvent *p, int manualReset, int signaled)
+{
+  int ret = pthread_mutex_init(&p->_mutex, NULL);
+  if (ret != 0)
+    return ret;
+  ret = pthread_cond_init(&p->_cond, NULL);
+  if (ret != 0)
+  {
+    pthread_mutex_destroy(&p->_mutex);
+    return ret;
+  }
+  p->_manualReset = manualReset;
+  p->_state = (signaled ? 1 : 0);
+  p->_created = 1;
+  return 0;
+}
+
+WRes Event_Close(CEvent *p)
+{
+  if (!p->_created)
+    return 0;
+  p->_created = 0;
+  pthread_cond_destroy(&p->_cond);
+  return pthread_mutex_destroy(&p->_mutex);
+}
+
+WRes Event_Wait(CEvent *p)
+{
+  pthread_mutex_lock(&p->_mutex);
+  while (p->_state == 0)
+    pthread_cond_wait(&p->_cond, &p->_mutex);
+  if (!p->_manualReset)
+    p->_state = 0;
+  return pthread_mutex_unlock(&p->_mutex);
+}
+
+WRes Event_Set(CEvent *p)
+{
+  pthread_mutex_lock(&p->_mutex);
+  p->_state = 1;
+  pthread_cond_broadcast(&p->_cond);
+  return pthread_mutex_unlock(&p->_mutex);
+}
+
+WRes Event_Reset(CEvent *p)
+{
+  pthread_mutex_lock(&p->_mutex);
+  p->_state = 0;
+  return pthread_mutex_unlock(&p->_mutex);
+}
+
+WRes ManualResetEvent_Create(CManualResetEvent *p, int signaled) { return Event_Create(p, 1, signaled); }
+WRes AutoResetEvent_Create(CAutoResetEvent *p, int signaled) { return Event_Create(p, 0, signaled); }
+WRes ManualResetEvent_CreateNotSignaled(CManualResetEvent *p) { return ManualResetEvent_Create(p, 0); }
+WRes AutoResetEvent_CreateNotSignaled(CAutoResetEvent *p) { return AutoResetEvent_Create(p, 0); }
+
+
+WRes Semaphore_Create(CSemaphore *p, UInt32 initCount, UInt32 maxCount)
+{
+  int ret;
+  if (initCount > maxCount || maxCount < 1)
+    return EINVAL;
+  ret = pthread_mutex_init(&p->_mutex, NULL);
+  if (ret != 0)
+    return ret;
+  ret = pthread_cond_init(&p->_cond, NULL);
+  if (ret != 0)
+  {
+    pthread_mutex_destroy(&p->_mutex);
+    return ret;
+  }
+  p->_count = initCount;
+  p->_maxCount = maxCount;
+  p->_created = 1;
+  return 0;
+}
+
+WRes Semaphore_Close(CSemaphore *p)
+{
+  if (!p->_created)
+    return 0;
+  p->_created = 0;
+  pthread_cond_destroy(&p->_cond);
+  return pthread_mutex_destroy(&p->_mutex);
+}
+
+WRes Semaphore_Wait(CSemaphore *p)
+{
+  pthread_mutex_lock(&p->_mutex);
+  while (p->_count < 1)
+    pthread_cond_wait(&p->_cond, &p->_mutex);
+  p->_count--;
+  return pthread_mutex_unlock(&p->_mutex);
+}
+
+WRes Semaphore_ReleaseN(CSemaphore *p, UInt32 num)
+{
+  if (num < 1)
+    return EINVAL;
+  pthread_mutex_lock(&p->_mutex);
+  if (num > p->_maxCount - p->_count)
+  {
+    pthread_mutex_unlock(&p->_mutex);
+    return EINVAL;
+  }
+  p->_count += num;
+  pthread_cond_broadcast(&p->_cond);
+  return pthread_mutex_unlock(&p->_mutex);
+}
+
+WRes Semaphore_Release1(CSemaphore *p) { return Semaphore_ReleaseN(p, 1); }
+
+WRes CriticalSection_Init(CCriticalSection *p)
+{
+  return pthread_mutex_init(p, NULL);
+}
+
+#endif
@@ -16,6 +16,7 @@ import os
 from Common.MultipleWorkspace import MultipleWorkspace as mws
 from AutoGen.AutoGen import AutoGen
 from Workspace.WorkspaceDatabase import BuildDB
+from Workspace.MetaFileCache import MetaFileCache
 try:
     from queue import Empty
 except:
@@ -147,12 +148,17 @@ class AutoGenManager(threading.Thread):
         self.error_event.set()
     def kill(self):
         self.feedback_q.put(None)
+#
+# data_pipe_file_path is a dict of {Arch: data pipe file}. Modules of all the
+# archs in it can be put into module_queue.
+#
 class AutoGenWorkerInProcess(mp.Process):
     def __init__(self,module_queue,data_pipe_file_path,feedback_q,file_lock,cache_q,log_q,error_event):
         mp.Process.__init__(self)
         self.module_queue = module_queue
         self.data_pipe_file_path =data_pipe_file_path
         self.data_pipe = None
+        self.data_pipes = {}
         self.feedback_q = feedback_q
         self.PlatformMetaFileSet = {}
         self.file_lock = file_lock
@@ -169,11 +175,13 @@ class AutoGenWorkerInProcess(mp.Process):
         try:
             taskname = "Init"
             with self.file_lock:
-                try:
-                    self.data_pipe = MemoryDataPipe()
-                    self.data_pipe.load(self.data_pipe_file_path)
-                except:
-                    self.feedback_q.put(taskname + ":" + "load data pipe %s failed." % self.data_pipe_file_path)
+                for arch in self.data_pipe_file_path:
+                    try:
+                        self.data_pipe = MemoryDataPipe()
+                        self.data_pipe.load(self.data_pipe_file_path[arch])
+                        self.data_pipes[arch] = self.data_pipe
+                    except:
+                        self.feedback_q.put(taskname + ":" + "load data pipe %s failed." % self.data_pipe_file_path[arch])
             EdkLogger.LogClientInitialize(self.log_q)
             loglevel = self.data_pipe.Get("LogLevel")
             if not loglevel:
@@ -198,6 +206,7 @@ class AutoGenWorkerInProcess(mp.Process):
             GlobalData.gDisableIncludePathCheck = False
             GlobalData.gFdfParser = self.data_pipe.Get("FdfParser")
             GlobalData.gDatabasePath = self.data_pipe.Get("DatabasePath")
+            MetaFileCache.Load()
 
             GlobalData.gUseHashCache = self.data_pipe.Get("UseHashCache")
             GlobalData.gBinCacheSource = self.data_pipe.Get("BinCacheSource")
@@ -220,10 +229,6 @@ class AutoGenWorkerInProcess(mp.Process):
                 pcd_from_build_option.append("=".join((pcd_id,pcd_tuple[3])))
             GlobalData.BuildOptionPcd = pcd_from_build_option
             module_count = 0
-            FfsCmd = self.data_pipe.Get("FfsCommand")
-            if FfsCmd is None:
-                FfsCmd = {}
-            GlobalData.FfsCmd = FfsCmd
             PlatformMetaFile = self.GetPlatformMetaFile(self.data_pipe.Get("P_Info").get("ActivePlatform"),
                                              self.data_pipe.Get("P_Info").get("WorkspaceDir"))
             while True:
@@ -243,6 +248,12 @@ class AutoGenWorkerInProcess(mp.Process):
                 if module_originalpath:
                     module_metafile.OriginalPath = PathClass(module_originalpath,module_root)
                 arch = module_arch
+                self.data_pipe = self.data_pipes[arch]
+                GlobalData.gGlobalDefines = self.data_pipe.Get("G_defines")
+                FfsCmd = self.data_pipe.Get("FfsCommand")
+                if FfsCmd is None:
+                    FfsCmd = {}
+                GlobalData.FfsCmd = FfsCmd
                 target = self.data_pipe.Get("P_Info").get("Target")
                 toolchain = self.data_pipe.Get("P_Info").get("ToolChain")
                 Ma = ModuleAutoGen(self.Wa,module_metafile,target,toolchain,arch,PlatformMetaFile,self.data_pipe)
@@ -1573,6 +1573,8 @@ class TopLevelMakefile(BuildFile):
             ExtraOption += " -c"
         if not GlobalData.gEnableGenfdsMultiThread:
             ExtraOption += " --no-genfds-multi-thread"
+        if GlobalData.gGenFvThreadNumber > 1:
+            ExtraOption += " -n %d" % GlobalData.gGenFvThreadNumber
         if GlobalData.gIgnoreSource:
             ExtraOption += " --ignore-sources"
 
@@ -113,6 +113,7 @@ class PlatformAutoGen(AutoGen):
 
         self._DynamicPcdList = None    # [(TokenCName1, TokenSpaceGuidCName1), (TokenCName2, TokenSpaceGuidCName2), ...]
         self._NonDynamicPcdList = None # [(TokenCName1, TokenSpaceGuidCName1), (TokenCName2, TokenSpaceGuidCName2), ...]
+        self._PcdListState = None      # content of the PCD lists shared by all archs when they were collected
 
         self._AsBuildInfList = []
         self._AsBuildModuleList = []
@@ -305,6 +306,23 @@ class PlatformAutoGen(AutoGen):
     def CollectPlatformDynamicPcds(self):
         self.CategoryPcds()
         self.SortDynamicPcd()
+        self._PcdListState = self._PcdListSignature()
+
+    ## Return the token names and values of the PCD lists shared by all archs
+    @staticmethod
+    def _PcdSignature(PcdList):
+        return frozenset((Pcd.TokenSpaceGuidCName, Pcd.TokenCName, Pcd.Type, str(Pcd.DefaultValue)) for Pcd in PcdList)
+
+    def _PcdListSignature(self):
+        return (self._PcdSignature(self._DynaPcdList_), self._PcdSignature(self._NonDynaPcdList_))
+
+    ## Check if the collected PCD lists need to be collected again
+    #
+    #  The dynamic PCD list is empty for a platform without dynamic PCD. Collecting
+    #  again gives the same result until other arch changes the PCDs in the shared lists.
+    #
+    def _PcdListChanged(self):
+        return self._PcdListState != self._PcdListSignature()
 
     def CategoryPcds(self):
         # Category Pcds into DynamicPcds and NonDynamicPcds
@@ -986,14 +1004,14 @@ class PlatformAutoGen(AutoGen):
     ## Get list of non-dynamic PCDs
     @property
     def NonDynamicPcdList(self):
-        if not self._NonDynamicPcdList:
+        if not self._NonDynamicPcdList and self._PcdListChanged():
             self.CollectPlatformDynamicPcds()
         return self._NonDynamicPcdList
 
     ## Get list of dynamic PCDs
     @property
     def DynamicPcdList(self):
-        if not self._DynamicPcdList:
+        if not self._DynamicPcdList and self._PcdListChanged():
             self.CollectPlatformDynamicPcds()
         return self._DynamicPcdList
 
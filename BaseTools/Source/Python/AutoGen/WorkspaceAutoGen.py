@@ -875,6 +875,7 @@ class WorkspaceAutoGen(AutoGen):
             FdsCommandDict["quiet"] = True
 
         FdsCommandDict["GenfdsMultiThread"] = GlobalData.gEnableGenfdsMultiThread
+        FdsCommandDict["GenFvThreads"] = GlobalData.gGenFvThreadNumber
         if GlobalData.gIgnoreSource:
             FdsCommandDict["IgnoreSources"] = True
 
@@ -117,6 +117,8 @@ gModuleAllCacheStatus = None
 gModuleCacheHit = None
 
 gEnableGenfdsMultiThread = True
+# Number of threads GenFv uses to read and check the FFS files of an FV
+gGenFvThreadNumber = 1
 gSikpAutoGenCache = set()
 # Common lock for the file access in multiple process AutoGens
 file_lock = None
@@ -94,11 +94,16 @@ def resetFdsGlobalVariable():
     GenFdsGlobalVariable.CopyList   = []
     GenFdsGlobalVariable.ModuleFile = ''
     GenFdsGlobalVariable.EnableGenfdsMultiThread = True
+    GenFdsGlobalVariable.GenFvThreads = 1
 
     GenFdsGlobalVariable.LargeFileInFvFlags = []
     GenFdsGlobalVariable.EFI_FIRMWARE_FILE_SYSTEM3_GUID = '5473C07A-3DCB-4dca-BD6F-1E9689E7349A'
     GenFdsGlobalVariable.LARGE_FILE_SIZE = 0x1000000
 
+    GenFdsGlobalVariable.ContentHashFile = ''
+    GenFdsGlobalVariable.ContentHashDict = {}
+    GenFdsGlobalVariable.PendingContentHash = {}
+
     GenFdsGlobalVariable.SectionHeader = Struct("3B 1B")
 
     # FvName, FdName, CapName in FDF, Image file name
@@ -119,6 +124,12 @@ def GenFdsApi(FdsCommandDict, WorkSpaceDataBase=None):
         if FdsCommandDict.get("FixedAddress"):
             GenFdsGlobalVariable.FixedLoadAddress = True
 
+        if FdsCommandDict.get("UseHashCache"):
+            GlobalData.gUseHashCache = True
+
+        if FdsCommandDict.get("GenFvThreads"):
+            GenFdsGlobalVariable.GenFvThreads = FdsCommandDict.get("GenFvThreads")
+
         if FdsCommandDict.get("quiet"):
             EdkLogger.SetLevel(EdkLogger.QUIET)
         if FdsCommandDict.get("debug"):
@@ -369,6 +380,7 @@ def GenFdsApi(FdsCommandDict, WorkSpaceDataBase=None):
 
         """Call GenFds"""
         GenFds.GenFd('', FdfParserObj, BuildWorkSpace, ArchList)
+        GenFdsGlobalVariable.SaveContentHash()
 
         """Generate GUID cross reference file"""
         GenFds.GenerateGuidXRefFile(BuildWorkSpace, ArchList, FdfParserObj)
@@ -407,6 +419,8 @@ def OptionsToCommandDict(Options):
     FdsCommandDict["debug"] = Options.debug
     FdsCommandDict["Workspace"] = Options.Workspace
     FdsCommandDict["GenfdsMultiThread"] = not Options.NoGenfdsMultiThread
+    FdsCommandDict["UseHashCache"] = Options.UseHashCache
+    FdsCommandDict["GenFvThreads"] = Options.ThreadNumber
     FdsCommandDict["fdf_file"] = [PathClass(Options.filename)] if Options.filename else []
     FdsCommandDict["build_target"] = Options.BuildTarget
     FdsCommandDict["toolchain_tag"] = Options.ToolChain
@@ -465,6 +479,8 @@ def myOptionParser():
     Parser.add_option("--pcd", action="append", dest="OptionPcd", help="Set PCD value by command line. Format: \"PcdName=Value\" ")
     Parser.add_option("--genfds-multi-thread", action="store_true", dest="GenfdsMultiThread", default=True, help="Enable GenFds multi thread to generate ffs file.")
     Parser.add_option("--no-genfds-multi-thread", action="store_true", dest="NoGenfdsMultiThread", default=False, help="Disable GenFds multi thread to generate ffs file.")
+    Parser.add_option("--hash", action="store_true", dest="UseHashCache", default=False, help="Skip regenerating FFS and FV files whose command and input content are not changed.")
+    Parser.add_option("-n", action="store", type="int", dest="ThreadNumber", help="Number of threads GenFv uses to read and check the FFS files of an FV.")
 
     Options, _ = Parser.parse_args()
     return Options
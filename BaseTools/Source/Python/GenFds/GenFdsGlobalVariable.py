@@ -14,6 +14,8 @@ from __future__ import absolute_import
 
 import Common.LongFilePathOs as os
 import sys
+import json
+import hashlib
 from sys import stdout
 from subprocess import PIPE,Popen
 from struct import Struct
@@ -71,6 +73,11 @@ class GenFdsGlobalVariable:
     CopyList   = []
     ModuleFile = ''
     EnableGenfdsMultiThread = True
+    #
+    # Number of threads GenFv uses to read and check the FFS files of an FV,
+    # GenFv accepts at most 64.
+    #
+    GenFvThreads = 1
 
     #
     # The list whose element are flags to indicate if large FFS or SECTION files exist in FV.
@@ -90,6 +97,15 @@ class GenFdsGlobalVariable:
     # FvName, FdName, CapName in FDF, Image file name
     ImageBinDict = {}
 
+    #
+    # Content hash of the command and inputs used to generate each output file,
+    # keyed by output path. It is only consulted when hash cache is enabled and
+    # lets an output be kept even if its inputs are newer but unchanged.
+    #
+    ContentHashFile = ''
+    ContentHashDict = {}
+    PendingContentHash = {}
+
     ## LoadBuildRule
     #
     @staticmethod
@@ -319,6 +335,73 @@ class GenFdsGlobalVariable:
 
         FvAddressFile.close()
 
+        GenFdsGlobalVariable.ContentHashFile = os.path.join(GenFdsGlobalVariable.FvDir, 'GenFds.hash')
+        GenFdsGlobalVariable.LoadContentHash()
+
+    ## LoadContentHash()
+    #
+    #   Load the content hash of the outputs generated by previous build
+    #
+    @staticmethod
+    def LoadContentHash():
+        GenFdsGlobalVariable.ContentHashDict = {}
+        GenFdsGlobalVariable.PendingContentHash = {}
+        if not GlobalData.gUseHashCache or not os.path.exists(GenFdsGlobalVariable.ContentHashFile):
+            return
+        try:
+            with open(GenFdsGlobalVariable.ContentHashFile, 'r') as File:
+                GenFdsGlobalVariable.ContentHashDict = json.load(File)
+        except:
+            EdkLogger.quiet("[cache warning]: fail to load GenFds hash file: %s" % GenFdsGlobalVariable.ContentHashFile)
+            GenFdsGlobalVariable.ContentHashDict = {}
+
+    ## SaveContentHash()
+    #
+    #   Save the content hash of the outputs for next build
+    #
+    @staticmethod
+    def SaveContentHash():
+        if not GlobalData.gUseHashCache or not GenFdsGlobalVariable.ContentHashFile:
+            return
+        try:
+            SaveFileOnChange(GenFdsGlobalVariable.ContentHashFile,
+                             json.dumps(GenFdsGlobalVariable.ContentHashDict, indent=0, sort_keys=True), False)
+        except:
+            EdkLogger.quiet("[cache warning]: fail to save GenFds hash file: %s" % GenFdsGlobalVariable.ContentHashFile)
+
+    ## GetContentHash()
+    #
+    #   @param  Cmd             Command used to generate the output
+    #   @param  Input           Path list of input files
+    #
+    #   @retval string          MD5 of the command and the content of all inputs
+    #
+    @staticmethod
+    def GetContentHash(Cmd, Input):
+        m = hashlib.md5()
+        m.update(' '.join(Cmd).encode('utf-8'))
+        for F in Input:
+            m.update(F.encode('utf-8'))
+            with open(F, 'rb') as File:
+                m.update(File.read())
+        return m.hexdigest()
+
+    ## UpdateContentHash()
+    #
+    #   Record the content hash of an output after its tool ran successfully
+    #
+    #   @param  Output          Path of output file
+    #
+    @staticmethod
+    def UpdateContentHash(Output):
+        Hash = GenFdsGlobalVariable.PendingContentHash.pop(Output, None)
+        if Hash is None:
+            return
+        if os.path.exists(Output):
+            GenFdsGlobalVariable.ContentHashDict[Output] = [Hash, os.path.getmtime(Output)]
+        else:
+            GenFdsGlobalVariable.ContentHashDict.pop(Output, None)
+
     @staticmethod
     def SetEnv(FdfParser, WorkSpace, ArchList, GlobalData):
         GenFdsGlobalVariable.ModuleFile = WorkSpace.ModuleFile
@@ -404,31 +487,65 @@ class GenFdsGlobalVariable:
     #
     #   @param  Output          Path of output file
     #   @param  Input           Path list of input files
+    #   @param  Cmd             Command to generate Output, used for hash cache
+    #   @param  HashInput       Path list of extra files only covered by hash
     #
     #   @retval True            if Output doesn't exist, or any Input is newer
-    #   @retval False           if all Input is older than Output
+    #   @retval False           if all Input is older than Output, or the
+    #                           command and content of Input are not changed
     #
     @staticmethod
-    def NeedsUpdate(Output, Input):
-        if not os.path.exists(Output):
-            return True
+    def NeedsUpdate(Output, Input, Cmd=None, HashInput=[]):
         # always update "Output" if no "Input" given
         if not Input:
             return True
 
+        OutputExist = os.path.exists(Output)
+        if OutputExist and GenFdsGlobalVariable.IsOutputUpToDate(Output, Input):
+            return False
+
+        #
+        # Timestamp says "Output" is out of date. With hash cache enabled, keep
+        # it if the command and the content of all inputs are the same as the
+        # ones it was generated from, otherwise remember the hash so that it
+        # can be recorded once "Output" is generated.
+        #
+        if Cmd is None or not GlobalData.gUseHashCache:
+            return True
+        AllInput = list(Input) + list(HashInput)
+        for F in AllInput:
+            if not os.path.exists(F):
+                return True
+        Hash = GenFdsGlobalVariable.GetContentHash(Cmd, AllInput)
+        if OutputExist and GenFdsGlobalVariable.ContentHashDict.get(Output) == [Hash, os.path.getmtime(Output)]:
+            GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s is up to date because its inputs are not changed" % Output)
+            return False
+        GenFdsGlobalVariable.PendingContentHash[Output] = Hash
+        return True
+
+    ## IsOutputUpToDate()
+    #
+    #   @param  Output          Path of output file
+    #   @param  Input           Path list of input files
+    #
+    #   @retval True            if Output is newer than fdf file and all Input
+    #   @retval False           if any Input doesn't exist or is newer
+    #
+    @staticmethod
+    def IsOutputUpToDate(Output, Input):
         # if fdf file is changed after the 'Output" is generated, update the 'Output'
         OutputTime = os.path.getmtime(Output)
         if GenFdsGlobalVariable.FdfFileTimeStamp > OutputTime:
-            return True
+            return False
 
         for F in Input:
             # always update "Output" if any "Input" doesn't exist
             if not os.path.exists(F):
-                return True
+                return False
             # always update "Output" if any "Input" is newer than "Output"
             if os.path.getmtime(F) > OutputTime:
-                return True
-        return False
+                return False
+        return True
 
     @staticmethod
     def GenerateSection(Output, Input, Type=None, CompressionType=None, Guid=None,
@@ -481,9 +598,10 @@ class GenFdsGlobalVariable:
                 if ' '.join(Cmd).strip() not in GenFdsGlobalVariable.SecCmdList:
                     GenFdsGlobalVariable.SecCmdList.append(' '.join(Cmd).strip())
             else:
-                if not GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
+                if not GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile], Cmd):
                     return
                 GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
+                GenFdsGlobalVariable.UpdateContentHash(Output)
         else:
             Cmd += ("-o", Output)
             Cmd += Input
@@ -496,9 +614,10 @@ class GenFdsGlobalVariable:
                     Cmd = ['-test', '-e', Input[0], "&&"] + Cmd
                 if ' '.join(Cmd).strip() not in GenFdsGlobalVariable.SecCmdList:
                     GenFdsGlobalVariable.SecCmdList.append(' '.join(Cmd).strip())
-            elif GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
+            elif GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile], Cmd):
                 GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s needs update because of newer %s" % (Output, Input))
                 GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
+                GenFdsGlobalVariable.UpdateContentHash(Output)
                 if (os.path.getsize(Output) >= GenFdsGlobalVariable.LARGE_FILE_SIZE and
                     GenFdsGlobalVariable.LargeFileInFvFlags):
                     GenFdsGlobalVariable.LargeFileInFvFlags[-1] = True
@@ -552,17 +671,14 @@ class GenFdsGlobalVariable:
             GenFdsGlobalVariable.SecCmdList = []
             GenFdsGlobalVariable.CopyList = []
         else:
-            if not GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
+            if not GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile], Cmd):
                 return
             GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate FFS")
+            GenFdsGlobalVariable.UpdateContentHash(Output)
 
     @staticmethod
     def GenerateFirmwareVolume(Output, Input, BaseAddress=None, ForceRebase=None, Capsule=False, Dump=False,
                                AddressFile=None, MapFile=None, FfsList=[], FileSystemGuid=None):
-        if not GenFdsGlobalVariable.NeedsUpdate(Output, Input+FfsList):
-            return
-        GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s needs update because of newer %s" % (Output, Input))
-
         Cmd = ["GenFv"]
         if BaseAddress:
             Cmd += ("-r", BaseAddress)
@@ -586,16 +702,28 @@ class GenFdsGlobalVariable:
         for I in Input:
             Cmd += ("-i", I)
 
+        #
+        # The address file is regenerated on each run and is read by GenFv,
+        # so it only takes part in the content hash.
+        #
+        if not GenFdsGlobalVariable.NeedsUpdate(Output, Input+FfsList, Cmd, [AddressFile] if AddressFile else []):
+            return
+        GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s needs update because of newer %s" % (Output, Input))
+
+        #
+        # The FV image does not depend on the thread count, so it is added
+        # after the content hash check.
+        #
+        if GenFdsGlobalVariable.GenFvThreads > 1:
+            Cmd += ("--threads", str(min(GenFdsGlobalVariable.GenFvThreads, 64)))
+
         GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate FV")
+        GenFdsGlobalVariable.UpdateContentHash(Output)
 
     @staticmethod
     def GenerateFirmwareImage(Output, Input, Type="efi", SubType=None, Zero=False,
                               Strip=False, Replace=False, TimeStamp=None, Join=False,
                               Align=None, Padding=None, Convert=False, IsMakefile=False):
-        if not GenFdsGlobalVariable.NeedsUpdate(Output, Input) and not IsMakefile:
-            return
-        GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s needs update because of newer %s" % (Output, Input))
-
         Cmd = ["GenFw"]
         if Type.lower() == "te":
             Cmd.append("-t")
@@ -619,11 +747,16 @@ class GenFdsGlobalVariable:
             Cmd.append("-m")
         Cmd += ("-o", Output)
         Cmd += Input
+        if not IsMakefile and not GenFdsGlobalVariable.NeedsUpdate(Output, Input, Cmd):
+            return
+        GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s needs update because of newer %s" % (Output, Input))
+
         if IsMakefile:
             if " ".join(Cmd).strip() not in GenFdsGlobalVariable.SecCmdList:
                 GenFdsGlobalVariable.SecCmdList.append(" ".join(Cmd).strip())
         else:
             GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate firmware image")
+            GenFdsGlobalVariable.UpdateContentHash(Output)
 
     @staticmethod
     def GenerateOptionRom(Output, EfiInput, BinaryInput, Compress=False, ClassCode=None,
@@ -647,11 +780,6 @@ class GenFdsGlobalVariable:
                 Cmd.append(BinFile)
                 InputList.append (BinFile)
 
-        # Check List
-        if not GenFdsGlobalVariable.NeedsUpdate(Output, InputList) and not IsMakefile:
-            return
-        GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s needs update because of newer %s" % (Output, InputList))
-
         if ClassCode:
             Cmd += ("-l", ClassCode)
         if Revision:
@@ -662,27 +790,40 @@ class GenFdsGlobalVariable:
             Cmd += ("-f", VendorId)
 
         Cmd += ("-o", Output)
+
+        # Check List
+        if not IsMakefile and not GenFdsGlobalVariable.NeedsUpdate(Output, InputList, Cmd):
+            return
+        GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s needs update because of newer %s" % (Output, InputList))
+
         if IsMakefile:
             if " ".join(Cmd).strip() not in GenFdsGlobalVariable.SecCmdList:
                 GenFdsGlobalVariable.SecCmdList.append(" ".join(Cmd).strip())
         else:
             GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate option rom")
+            GenFdsGlobalVariable.UpdateContentHash(Output)
 
     @staticmethod
     def GuidTool(Output, Input, ToolPath, Options='', returnValue=[], IsMakefile=False):
-        if not GenFdsGlobalVariable.NeedsUpdate(Output, Input) and not IsMakefile:
-            return
-        GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s needs update because of newer %s" % (Output, Input))
-
         Cmd = [ToolPath, ]
         Cmd += Options.split(' ')
         Cmd += ("-o", Output)
         Cmd += Input
+
+        #
+        # A caller passing returnValue tolerates the tool failure, so its
+        # output is never taken from the hash cache.
+        #
+        if not IsMakefile and not GenFdsGlobalVariable.NeedsUpdate(Output, Input, Cmd if returnValue == [] else None):
+            return
+        GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s needs update because of newer %s" % (Output, Input))
+
         if IsMakefile:
             if " ".join(Cmd).strip() not in GenFdsGlobalVariable.SecCmdList:
                 GenFdsGlobalVariable.SecCmdList.append(" ".join(Cmd).strip())
         else:
             GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to call " + ToolPath, returnValue)
+            GenFdsGlobalVariable.UpdateContentHash(Output)
 
     @staticmethod
     def CallExternalTool (cmd, errorMess, returnValue=[]):
@@ -0,0 +1,137 @@
+## @file
+# This file is used to persist the parsed records of INF and DEC files
+#
+# The records of a meta file only depend on its own content, so they can be
+# shared by the build process, its AutoGen worker processes and later builds
+# as long as the file is not changed.
+#
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+from __future__ import absolute_import
+import os
+import pickle
+from pickle import HIGHEST_PROTOCOL
+
+import Common.EdkLogger as EdkLogger
+import Common.GlobalData as GlobalData
+from CommonDataClass.DataClass import MODEL_FILE_DEC, MODEL_FILE_INF
+
+## MetaFileCache
+#
+#   Cache of parsed INF/DEC records, keyed by the meta file path. Each entry
+# is validated against the modification time and size of the file before use.
+#
+class MetaFileCache(object):
+    # bump it whenever the format of parsed records is changed
+    _VERSION_ = 1
+    _FILE_NAME_ = 'MetaFile.cache'
+    _FILE_TYPE_ = (MODEL_FILE_INF, MODEL_FILE_DEC)
+
+    # column index of ID and BelongsToItem in table record
+    _ID_ = 0
+    _BELONGS_TO_ITEM_ = 7
+
+    _Records = {}   # FilePath : (mtime, size, base ID, records)
+    _Dirty = False
+
+    ## Get the path of cache file, which is in the same folder of build.db
+    @staticmethod
+    def GetCacheFile():
+        return os.path.join(os.path.dirname(GlobalData.gDatabasePath), MetaFileCache._FILE_NAME_)
+
+    ## Load the cache file generated by previous build or parent process
+    @classmethod
+    def Load(cls):
+        cls._Records = {}
+        cls._Dirty = False
+        CacheFile = cls.GetCacheFile()
+        if not os.path.exists(CacheFile):
+            return
+        try:
+            with open(CacheFile, 'rb') as File:
+                Version, Records = pickle.load(File)
+            if Version == cls._VERSION_:
+                cls._Records = Records
+        except:
+            EdkLogger.debug(EdkLogger.DEBUG_5, "Failed to load meta file cache %s" % CacheFile)
+            cls._Records = {}
+
+    ## Save the cache file if any meta file is parsed after loading
+    @classmethod
+    def Save(cls):
+        if not cls._Dirty:
+            return
+        CacheFile = cls.GetCacheFile()
+        try:
+            with open(CacheFile, 'wb') as File:
+                pickle.dump((cls._VERSION_, cls._Records), File, HIGHEST_PROTOCOL)
+            cls._Dirty = False
+        except:
+            EdkLogger.debug(EdkLogger.DEBUG_5, "Failed to save meta file cache %s" % CacheFile)
+
+    @staticmethod
+    def _GetFileStamp(FilePath):
+        try:
+            Stat = os.stat(FilePath)
+        except:
+            return None
+        return (Stat.st_mtime, Stat.st_size)
+
+    ## Fill the table of parser with cached records
+    #
+    #   @param  Parser      The InfParser or DecParser object
+    #
+    #   @retval True        The table is filled and the parse is done
+    #   @retval False       The file needs to be parsed
+    #
+    @classmethod
+    def Restore(cls, Parser):
+        if Parser._FileType not in cls._FILE_TYPE_:
+            return False
+        FilePath = str(Parser.MetaFile)
+        Entry = cls._Records.get(FilePath)
+        if Entry is None:
+            return False
+        Stamp = cls._GetFileStamp(FilePath)
+        if Stamp is None or Stamp != Entry[0:2]:
+            return False
+
+        #
+        # IDs are numbered from the file ID in current database, so rebase
+        # them, as well as the references to them.
+        #
+        Table = Parser._Table
+        Delta = Table.FileId * 10**8 - Entry[2]
+        Content = []
+        for Record in Entry[3]:
+            Record = list(Record)
+            Record[cls._ID_] += Delta
+            if Record[cls._BELONGS_TO_ITEM_] >= 0:
+                Record[cls._BELONGS_TO_ITEM_] += Delta
+            Content.append(Record)
+        Table.CurrentContent = Content
+        if Content:
+            Table.ID = Content[-1][cls._ID_]
+        Parser._Done()
+        return True
+
+    ## Record the parsed records of the table of parser
+    #
+    #   @param  Parser      The InfParser or DecParser object
+    #
+    @classmethod
+    def Record(cls, Parser):
+        if Parser._FileType not in cls._FILE_TYPE_ or not Parser.Finished:
+            return
+        FilePath = str(Parser.MetaFile)
+        Stamp = cls._GetFileStamp(FilePath)
+        if Stamp is None:
+            return
+        Table = Parser._Table
+        Records = [tuple(Record) for Record in Table.CurrentContent if Record[cls._ID_] >= 0]
+        cls._Records[FilePath] = Stamp + (Table.FileId * 10**8, Records)
+        cls._Dirty = True
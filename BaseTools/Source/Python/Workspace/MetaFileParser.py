@@ -29,6 +29,7 @@ from CommonDataClass.Exceptions import *
 from Common.LongFilePathSupport import OpenLongFilePath as open
 from collections import defaultdict
 from .MetaFileTable import MetaFileStorage
+from .MetaFileCache import MetaFileCache
 from .MetaFileCommentParser import CheckInfComment
 from Common.DataType import TAB_COMMENT_EDK_START, TAB_COMMENT_EDK_END
 
@@ -258,7 +259,10 @@ class MetaFileParser(object):
             else:
                 self._Table = self._RawTable
                 self._PostProcessed = False
-                self.Start()
+                # INF/DEC records parsed by previous build or parent process
+                if not MetaFileCache.Restore(self):
+                    self.Start()
+                    MetaFileCache.Record(self)
     ## Data parser for the common format in different type of file
     #
     #   The common format in the meatfile is like
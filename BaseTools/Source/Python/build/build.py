@@ -47,6 +47,7 @@ from Common.DataType import *
 import Common.EdkLogger as EdkLogger
 
 from Workspace.WorkspaceDatabase import BuildDB
+from Workspace.MetaFileCache import MetaFileCache
 
 from BuildReport import BuildReport
 from GenPatchPcdTable.GenPatchPcdTable import PeImageClass,parsePcdInfoFromMapFile
@@ -781,6 +782,7 @@ class Build():
         GlobalData.gDatabasePath = os.path.normpath(os.path.join(GlobalData.gConfDirectory, GlobalData.gDatabasePath))
         if not os.path.exists(os.path.join(GlobalData.gConfDirectory, '.cache')):
             os.makedirs(os.path.join(GlobalData.gConfDirectory, '.cache'))
+        MetaFileCache.Load()
         self.Db = BuildDB
         self.BuildDatabase = self.Db.BuildObject
         self.Platform = None
@@ -845,23 +847,33 @@ class Build():
         GlobalData.gModuleAllCacheStatus = set()
         GlobalData.gModuleCacheHit = set()
 
-    def StartAutoGen(self,mqueue, DataPipe,SkipAutoGen,PcdMaList,cqueue):
+    ## Start AutoGen workers for the modules in mqueue
+    #
+    #   @param  DataPipeList    The data pipes of all archs whose modules are in mqueue
+    #
+    def StartAutoGen(self,mqueue, DataPipeList,SkipAutoGen,PcdMaList,cqueue):
         try:
             if SkipAutoGen:
                 return True,0
+            # Share the parsed INF/DEC files with workers
+            MetaFileCache.Save()
             feedback_q = mp.Queue()
             error_event = mp.Event()
+            DataPipe = DataPipeList[0]
             FfsCmd = DataPipe.Get("FfsCommand")
             if FfsCmd is None:
                 FfsCmd = {}
             GlobalData.FfsCmd = FfsCmd
-            auto_workers = [AutoGenWorkerInProcess(mqueue,DataPipe.dump_file,feedback_q,GlobalData.file_lock,cqueue,self.log_q,error_event) for _ in range(self.ThreadNumber)]
+            DataPipeFiles = dict((Pipe.Get("P_Info").get("Arch"), Pipe.dump_file) for Pipe in DataPipeList)
+            auto_workers = [AutoGenWorkerInProcess(mqueue,DataPipeFiles,feedback_q,GlobalData.file_lock,cqueue,self.log_q,error_event) for _ in range(self.ThreadNumber)]
             self.AutoGenMgr = AutoGenManager(auto_workers,feedback_q,error_event)
             self.AutoGenMgr.start()
             for w in auto_workers:
                 w.start()
             if PcdMaList is not None:
+                Arch = GlobalData.gGlobalDefines.get('ARCH')
                 for PcdMa in PcdMaList:
+                    GlobalData.gGlobalDefines['ARCH'] = PcdMa.Arch
                     # SourceFileList calling sequence impact the makefile string sequence.
                     # Create cached SourceFileList here to unify its calling sequence for both
                     # CanSkipbyPreMakeCache and CreateCodeFile/CreateMakeFile.
@@ -876,6 +888,8 @@ class Build():
                     # Force cache miss for PCD driver
                     if GlobalData.gBinCacheSource and self.Target in [None, "", "all"]:
                         cqueue.put((PcdMa.MetaFile.Path, PcdMa.Arch, "MakeCache", False))
+                if Arch is not None:
+                    GlobalData.gGlobalDefines['ARCH'] = Arch
 
             self.AutoGenMgr.join()
             rt = self.AutoGenMgr.Status
@@ -949,6 +963,7 @@ class Build():
 
             self.PlatformFile = PathClass(NormFile(PlatformFile, self.WorkspaceDir), self.WorkspaceDir)
         self.ThreadNumber   = ThreadNum()
+        GlobalData.gGenFvThreadNumber = self.ThreadNumber
     ## Initialize build configuration
     #
     #   This method will parse DSC file and merge the configurations from
@@ -1224,7 +1239,7 @@ class Build():
             data_pipe_file = os.path.join(AutoGenObject.BuildDir, "GlobalVar_%s_%s.bin" % (str(AutoGenObject.Guid),AutoGenObject.Arch))
             AutoGenObject.DataPipe.dump(data_pipe_file)
             cqueue = mp.Queue()
-            autogen_rt,errorcode = self.StartAutoGen(mqueue, AutoGenObject.DataPipe, self.SkipAutoGen, PcdMaList, cqueue)
+            autogen_rt,errorcode = self.StartAutoGen(mqueue, [AutoGenObject.DataPipe], self.SkipAutoGen, PcdMaList, cqueue)
             AutoGenIdFile = os.path.join(GlobalData.gConfDirectory,".AutoGenIdFile.txt")
             with open(AutoGenIdFile,"w") as fw:
                 fw.write("Arch=%s\n" % "|".join((AutoGenObject.Workspace.ArchList)))
@@ -2107,8 +2122,16 @@ class Build():
 
         self.AutoGenTime += int(round((time.time() - WorkspaceAutoGenTime)))
         BuildModules = []
+        PcdMaList    = []
+        DataPipeList = []
+        PaDict       = {}
+        #
+        # Modules of all archs are put into one queue and handled by one pool
+        # of AutoGen workers, so that a multi-arch build keeps all workers busy.
+        #
+        mqueue = mp.Queue()
+        cqueue = mp.Queue()
         for Arch in Wa.ArchList:
-            PcdMaList    = []
             AutoGenStart = time.time()
             GlobalData.gGlobalDefines['ARCH'] = Arch
             Pa = PlatformAutoGen(Wa, self.PlatformFile, BuildTarget, ToolChain, Arch)
@@ -2155,8 +2178,6 @@ class Build():
                 self.AllDrivers.add(Ma)
                 self.AllModules.add(Ma)
 
-            mqueue = mp.Queue()
-            cqueue = mp.Queue()
             for m in Pa.GetAllModuleInfo:
                 mqueue.put(m)
                 module_file,module_root,module_path,module_basename,\
@@ -2166,8 +2187,13 @@ class Build():
                 self.AllModules.add(Ma)
             data_pipe_file = os.path.join(Pa.BuildDir, "GlobalVar_%s_%s.bin" % (str(Pa.Guid),Pa.Arch))
             Pa.DataPipe.dump(data_pipe_file)
+            DataPipeList.append(Pa.DataPipe)
+            PaDict[Arch] = Pa
+            self.AutoGenTime += int(round((time.time() - AutoGenStart)))
 
-            autogen_rt, errorcode = self.StartAutoGen(mqueue, Pa.DataPipe, self.SkipAutoGen, PcdMaList, cqueue)
+        if DataPipeList:
+            AutoGenStart = time.time()
+            autogen_rt, errorcode = self.StartAutoGen(mqueue, DataPipeList, self.SkipAutoGen, PcdMaList, cqueue)
 
             if not autogen_rt:
                 self.AutoGenMgr.TerminateWorkers()
@@ -2178,7 +2204,7 @@ class Build():
                 for item in GlobalData.gModuleAllCacheStatus:
                     (MetaFilePath, Arch, CacheStr, Status) = item
                     Ma = ModuleAutoGen(Wa, PathClass(MetaFilePath, Wa), BuildTarget,\
-                                      ToolChain, Arch, self.PlatformFile,Pa.DataPipe)
+                                      ToolChain, Arch, self.PlatformFile,PaDict[Arch].DataPipe)
                     if CacheStr == "PreMakeCache" and Status == False:
                         self.PreMakeCacheMiss.add(Ma)
                     if CacheStr == "PreMakeCache" and Status == True:
@@ -86,26 +86,34 @@ FatDiscardODir (
 
   Volume  = OFile->Volume;
   ODir    = OFile->ODir;
-  if (!OFile->DirEnt->Invalid) {
+  //
+  // A directory larger than the whole entry budget is not cached, so that it
+  // does not push every other directory out of the cache.
+  //
+  if (!OFile->DirEnt->Invalid &&
+      ODir->DirEntCount <= PcdGet32 (PcdFatMaxDirCacheEntryCount)) {
     //
     // If OFile does not represent a deleted file, then we will cache the directory
     // We use OFile's first cluster as the directory's tag
     //
     ODir->DirCacheTag = OFile->FileCluster;
     InsertHeadList (&Volume->DirCacheList, &ODir->DirCacheLink);
-    if (Volume->DirCacheCount == FAT_MAX_DIR_CACHE_COUNT) {
-      //
-      // Replace the least recent used directory
-      //
+    Volume->DirCacheCount++;
+    Volume->DirCacheEntryCount += ODir->DirEntCount;
+    //
+    // Replace the least recent used directories until the cache is within
+    // its budget.
+    //
+    while (Volume->DirCacheCount > PcdGet32 (PcdFatMaxDirCacheCount) ||
+           Volume->DirCacheEntryCount > PcdGet32 (PcdFatMaxDirCacheEntryCount)) {
       ODir = ODIR_FROM_DIRCACHELINK (Volume->DirCacheList.BackLink);
       RemoveEntryList (&ODir->DirCacheLink);
-    } else {
-      //
-      // No need to find a replace
-      //
-      Volume->DirCacheCount++;
-      ODir = NULL;
+      Volume->DirCacheCount--;
+      Volume->DirCacheEntryCount -= ODir->DirEntCount;
+      FatFreeODir (ODir);
     }
+
+    ODir = NULL;
   }
   //
   // Release ODir Structure
@@ -147,6 +155,8 @@ FatRequestODir (
     if (CurrentODir->DirCacheTag == DirCacheTag) {
       RemoveEntryList (&CurrentODir->DirCacheLink);
       Volume->DirCacheCount--;
+      Volume->DirCacheEntryCount -= CurrentODir->DirEntCount;
+      Volume->DirCacheHits++;
       ODir = CurrentODir;
       break;
     }
@@ -156,6 +166,7 @@ FatRequestODir (
     //
     // This directory is not cached, then allocate a new one
     //
+    Volume->DirCacheMisses++;
     ODir = FatAllocateODir (OFile);
   }
 
@@ -175,10 +186,22 @@ FatCleanupODirCache (
   )
 {
   FAT_ODIR  *ODir;
+
+  DEBUG ((
+    DEBUG_INFO,
+    "FatCleanupODirCache: directory cache hits %Lu misses %Lu, name index hits %Lu rescans %Lu\n",
+    (UINT64) Volume->DirCacheHits,
+    (UINT64) Volume->DirCacheMisses,
+    (UINT64) Volume->DirIndexHits,
+    (UINT64) Volume->DirIndexRescans
+    ));
+
   while (Volume->DirCacheCount > 0) {
     ODir = ODIR_FROM_DIRCACHELINK (Volume->DirCacheList.BackLink);
     RemoveEntryList (&ODir->DirCacheLink);
     FatFreeODir (ODir);
     Volume->DirCacheCount--;
   }
+
+  Volume->DirCacheEntryCount = 0;
 }
@@ -321,6 +321,7 @@ FatAddDirEnt (
   }
   InsertTailList (DirEnt->Link.BackLink, &DirEnt->Link);
   FatInsertToHashTable (ODir, DirEnt);
+  ODir->DirEntCount++;
 }
 
 /**
@@ -528,6 +529,11 @@ FatSearchODir (
   if (DirEnt == NULL && PossibleShortName) {
       DirEnt = *FatShortNameHashSearch (ODir, File8Dot3Name);
   }
+  if (DirEnt != NULL || ODir->EndOfDir) {
+    OFile->Volume->DirIndexHits++;
+  } else {
+    OFile->Volume->DirIndexRescans++;
+  }
   if (DirEnt == NULL) {
     //
     // We fail to get the directory entry from hash table; we then
@@ -1102,6 +1108,7 @@ FatRemoveDirEnt (
   // Remove from directory entry list
   //
   RemoveEntryList (&DirEnt->Link);
+  ODir->DirEntCount--;
   //
   // Remove from hash table
   //
@@ -152,12 +152,179 @@ FatExchangeCachePage (
   return EFI_SUCCESS;
 }
 
+/**
+
+  Write the dirty data cache pages in the range back to disk.
+
+  A non-blocking read of the range only completes after FatAccessCache() returns,
+  so the dirty data cannot be merged into the user buffer as FatFlushDataCacheRange()
+  does for a blocking read; the disk must hold the latest data before the read is queued.
+
+  @param  Volume                - FAT file system volume.
+  @param  StartPageNo           - First PageNo to be checked in the cache.
+  @param  EndPageNo             - Last PageNo to be checked in the cache.
+
+  @retval EFI_SUCCESS           - The dirty pages in the range are written back successfully.
+  @return Others                - An error occurred when writing the pages.
+
+**/
+STATIC
+EFI_STATUS
+FatWriteBackDataCacheRange (
+  IN FAT_VOLUME         *Volume,
+  IN UINTN              StartPageNo,
+  IN UINTN              EndPageNo
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       PageNo;
+  DISK_CACHE  *DiskCache;
+  CACHE_TAG   *CacheTag;
+
+  DiskCache = &Volume->DiskCache[CacheData];
+  for (PageNo = StartPageNo; PageNo < EndPageNo; PageNo++) {
+    CacheTag = &DiskCache->CacheTag[PageNo & DiskCache->GroupMask];
+    if (CacheTag->RealSize > 0 && CacheTag->PageNo == PageNo && CacheTag->Dirty) {
+      Status = FatExchangeCachePage (Volume, CacheData, WriteDisk, CacheTag, NULL);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Get the number of cache pages to load from disk on the read miss of PageNo.
+
+  A miss on the page following the pages read last time is taken as sequential
+  access and doubles the read-ahead window, up to MaxReadAheadCount; any other
+  miss resets it to one page. The pages are loaded into consecutive cache groups,
+  so the window stops at the end of the cache, and before any group holding a
+  dirty page or the wanted page already.
+
+  @param  DiskCache             - The disk cache.
+  @param  PageNo                - The missed page.
+
+  @return The number of pages to load, at least 1.
+
+**/
+STATIC
+UINTN
+FatGetReadAheadCount (
+  IN DISK_CACHE         *DiskCache,
+  IN UINTN              PageNo
+  )
+{
+  UINTN       GroupNo;
+  UINTN       Count;
+  UINTN       Index;
+  UINT64      MaxSize;
+  CACHE_TAG   *CacheTag;
+
+  if (PageNo == DiskCache->NextPageNo && DiskCache->ReadAheadCount > 0) {
+    DiskCache->ReadAheadCount = MIN (DiskCache->ReadAheadCount * 2, DiskCache->MaxReadAheadCount);
+  } else {
+    DiskCache->ReadAheadCount = 1;
+  }
+
+  GroupNo = PageNo & DiskCache->GroupMask;
+  Count   = MIN (DiskCache->ReadAheadCount, DiskCache->GroupMask + 1 - GroupNo);
+
+  //
+  // Do not read beyond the end of the cached area
+  //
+  MaxSize = DiskCache->LimitAddress - DiskCache->BaseAddress - LShiftU64 (PageNo, DiskCache->PageAlignment);
+  if (RShiftU64 (MaxSize, DiskCache->PageAlignment) < Count) {
+    Count = (UINTN) RShiftU64 (MaxSize + ((UINTN)1 << DiskCache->PageAlignment) - 1, DiskCache->PageAlignment);
+  }
+
+  for (Index = 1; Index < Count; Index++) {
+    CacheTag = &DiskCache->CacheTag[GroupNo + Index];
+    if (CacheTag->RealSize > 0 && (CacheTag->Dirty || CacheTag->PageNo == PageNo + Index)) {
+      break;
+    }
+  }
+
+  return MAX (Index, 1);
+}
+
+/**
+
+  Load Count consecutive pages from disk into the cache with one disk read.
+
+  @param  Volume                - FAT file system volume.
+  @param  DataType              - Indicate the cache type.
+  @param  PageNo                - The first page to load.
+  @param  Count                 - The number of pages to load.
+
+  @retval EFI_SUCCESS           - The cache pages are loaded successfully.
+  @return Others                - An error occurred when reading the pages.
+
+**/
+STATIC
+EFI_STATUS
+FatLoadCachePages (
+  IN FAT_VOLUME         *Volume,
+  IN CACHE_DATA_TYPE    DataType,
+  IN UINTN              PageNo,
+  IN UINTN              Count
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       GroupNo;
+  UINTN       Index;
+  UINTN       PageSize;
+  UINTN       Size;
+  UINT64      EntryPos;
+  UINT64      MaxSize;
+  DISK_CACHE  *DiskCache;
+  CACHE_TAG   *CacheTag;
+  UINT8       PageAlignment;
+
+  DiskCache     = &Volume->DiskCache[DataType];
+  GroupNo       = PageNo & DiskCache->GroupMask;
+  PageAlignment = DiskCache->PageAlignment;
+  PageSize      = (UINTN)1 << PageAlignment;
+  EntryPos      = DiskCache->BaseAddress + LShiftU64 (PageNo, PageAlignment);
+  Size          = Count << PageAlignment;
+  MaxSize       = DiskCache->LimitAddress - EntryPos;
+  if (MaxSize < Size) {
+    Size = (UINTN) MaxSize;
+  }
+
+  Status = FatDiskIo (
+             Volume,
+             ReadDisk,
+             EntryPos,
+             Size,
+             DiskCache->CacheBase + (GroupNo << PageAlignment),
+             NULL
+             );
+
+  for (Index = 0; Index < Count; Index++) {
+    CacheTag          = &DiskCache->CacheTag[GroupNo + Index];
+    CacheTag->PageNo  = PageNo + Index;
+    CacheTag->Dirty   = FALSE;
+    if (EFI_ERROR (Status)) {
+      CacheTag->RealSize = 0;
+    } else {
+      CacheTag->RealSize = MIN (PageSize, Size - (Index << PageAlignment));
+    }
+  }
+
+  return Status;
+}
+
 /**
 
   Get one cache page by specified PageNo.
 
   @param  Volume                - FAT file system volume.
   @param  CacheDataType         - The cache type: CACHE_FAT or CACHE_DATA.
+  @param  IoMode                - Indicate the page is got for read or write.
   @param  PageNo                - PageNo to match with the cache.
   @param  CacheTag              - The Cache Tag for the current cache page.
 
@@ -170,12 +337,15 @@ EFI_STATUS
 FatGetCachePage (
   IN FAT_VOLUME         *Volume,
   IN CACHE_DATA_TYPE    CacheDataType,
+  IN IO_MODE            IoMode,
   IN UINTN              PageNo,
   IN CACHE_TAG          *CacheTag
   )
 {
   EFI_STATUS  Status;
   UINTN       OldPageNo;
+  UINTN       Count;
+  DISK_CACHE  *DiskCache;
 
   OldPageNo = CacheTag->PageNo;
   if (CacheTag->RealSize > 0 && OldPageNo == PageNo) {
@@ -195,8 +365,18 @@ FatGetCachePage (
     }
   }
   //
-  // Load new data from disk;
+  // Load new data from disk, together with the following pages
+  // if the pages are read sequentially
   //
+  if (IoMode == ReadDisk) {
+    DiskCache             = &Volume->DiskCache[CacheDataType];
+    Count                 = FatGetReadAheadCount (DiskCache, PageNo);
+    DiskCache->NextPageNo = PageNo + Count;
+    if (Count > 1) {
+      return FatLoadCachePages (Volume, CacheDataType, PageNo, Count);
+    }
+  }
+
   CacheTag->PageNo  = PageNo;
   Status            = FatExchangeCachePage (Volume, CacheDataType, ReadDisk, CacheTag, NULL);
 
@@ -242,7 +422,7 @@ FatAccessUnalignedCachePage (
   DiskCache = &Volume->DiskCache[CacheDataType];
   GroupNo   = PageNo & DiskCache->GroupMask;
   CacheTag  = &DiskCache->CacheTag[GroupNo];
-  Status    = FatGetCachePage (Volume, CacheDataType, PageNo, CacheTag);
+  Status    = FatGetCachePage (Volume, CacheDataType, IoMode, PageNo, CacheTag);
   if (!EFI_ERROR (Status)) {
     Source      = DiskCache->CacheBase + (GroupNo << DiskCache->PageAlignment) + Offset;
     Destination = Buffer;
@@ -349,6 +529,13 @@ FatAccessCache (
     //
     ASSERT (CacheDataType == CacheData);
 
+    if (Task != NULL && IoMode == ReadDisk) {
+      Status = FatWriteBackDataCacheRange (Volume, PageNo, OverRunPageNo);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
+
     EntryPos    = Volume->RootPos + LShiftU64 (PageNo, PageAlignment);
     AlignedSize = AlignedPageCount << PageAlignment;
     Status      = FatDiskIo (Volume, IoMode, EntryPos, AlignedSize, Buffer, Task);
@@ -362,6 +549,12 @@ FatAccessCache (
     FatFlushDataCacheRange (Volume, IoMode, PageNo, OverRunPageNo, Buffer);
     Buffer      += AlignedSize;
     BufferSize  -= AlignedSize;
+    //
+    // A following read miss of the next page is still sequential
+    //
+    if (IoMode == ReadDisk) {
+      DiskCache->NextPageNo = OverRunPageNo;
+    }
   }
   //
   // The access of the OverRun data
@@ -472,6 +665,8 @@ FatInitializeDiskCache (
   DiskCache[CacheFat].GroupMask      = FatCacheGroupCount - 1;
   DiskCache[CacheFat].BaseAddress    = Volume->FatPos;
   DiskCache[CacheFat].LimitAddress   = Volume->FatPos + Volume->FatSize;
+  DiskCache[CacheData].MaxReadAheadCount = FAT_DATACACHE_READ_AHEAD_MAX_COUNT;
+  DiskCache[CacheFat].MaxReadAheadCount  = MIN (FatCacheGroupCount, FAT_FATCACHE_READ_AHEAD_MAX_COUNT);
   FatCacheSize                        = FatCacheGroupCount << DiskCache[CacheFat].PageAlignment;
   DataCacheSize                       = FAT_DATACACHE_GROUP_COUNT << DiskCache[CacheData].PageAlignment;
   //
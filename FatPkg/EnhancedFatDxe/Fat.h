@@ -84,6 +84,17 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define FAT_FATCACHE_GROUP_MIN_COUNT      1
 #define FAT_FATCACHE_GROUP_MAX_COUNT      16
 
+//
+// Max number of cache pages loaded in one disk read on sequential cache misses
+//
+#define FAT_DATACACHE_READ_AHEAD_MAX_COUNT  16
+#define FAT_FATCACHE_READ_AHEAD_MAX_COUNT   4
+
+//
+// Number of FAT16/FAT32 entries read at a time to build the free cluster bitmap
+//
+#define FAT_BITMAP_READ_ENTRIES           256
+
 //
 // Used in 8.3 generation algorithm
 //
@@ -104,7 +115,6 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define LC_ISO_639_2_ENTRY_SIZE 3
 #define MAX_LANG_CODE_SIZE      100
 
-#define FAT_MAX_DIR_CACHE_COUNT 8
 #define FAT_MAX_DIRENTRY_COUNT  0xFFFF
 typedef CHAR8                   LC_ISO_639_2;
 
@@ -156,6 +166,9 @@ typedef struct {
   BOOLEAN   Dirty;
   UINT8     PageAlignment;
   UINTN     GroupMask;
+  UINTN     NextPageNo;         // Page following the last page read, to detect sequential access
+  UINTN     ReadAheadCount;     // Current read-ahead window in pages
+  UINTN     MaxReadAheadCount;
   CACHE_TAG CacheTag[FAT_DATACACHE_GROUP_COUNT];
 } DISK_CACHE;
 
@@ -183,6 +196,7 @@ struct _FAT_DIRENT {
   FAT_OFILE           *OFile;                 // The OFile of the corresponding directory entry
   FAT_DIRENT          *ShortNameForwardLink;  // Hash successor link for short filename
   FAT_DIRENT          *LongNameForwardLink;   // Hash successor link for long filename
+  UINT32              LongNameHash;           // Hash value of the upper-cased long filename
   LIST_ENTRY          Link;                   // Connection of every directory entry
   FAT_DIRECTORY_ENTRY Entry;                  // The physical directory entry stored in disk
 };
@@ -193,6 +207,7 @@ struct _FAT_ODIR {
   UINT32              CurrentPos;             // Current position of the directory
   LIST_ENTRY          *CurrentCursor;         // Current directory entry pointer
   LIST_ENTRY          ChildList;              // List of all directory entries
+  UINTN               DirEntCount;            // Count of directory entries in ChildList
   BOOLEAN             EndOfDir;               // Indicate whether we have reached the end of the directory
   LIST_ENTRY          DirCacheLink;           // Linked in Volume->DirCacheList when discarded
   UINTN               DirCacheTag;            // The identification of the directory when in directory cache
@@ -335,6 +350,7 @@ struct _FAT_VOLUME {
   FAT_INFO_SECTOR                 FatInfoSector;  // Free cluster info
   UINTN                           FreeInfoPos;    // Pos with the free cluster info
   BOOLEAN                         FreeInfoValid;  // If free cluster info is valid
+  UINT8                           *FreeClusterBitmap; // Bit set if the cluster is free, built on first allocation
   //
   // Unpacked Fat BPB info
   //
@@ -369,6 +385,15 @@ struct _FAT_VOLUME {
   //
   LIST_ENTRY                      DirCacheList;
   UINTN                           DirCacheCount;
+  UINTN                           DirCacheEntryCount; // Count of directory entries in DirCacheList
+
+  //
+  // Directory lookup statistics, reported when the volume is freed
+  //
+  UINTN                           DirCacheHits;     // Directories reused from DirCacheList
+  UINTN                           DirCacheMisses;   // Directories read again from disk
+  UINTN                           DirIndexHits;     // Name lookups answered by the hash tables
+  UINTN                           DirIndexRescans;  // Name lookups that read more entries from disk
 
   //
   // Disk Cache for this volume
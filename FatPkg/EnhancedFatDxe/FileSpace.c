@@ -121,6 +121,138 @@ FatGetFatEntry (
   return Accum;
 }
 
+/**
+
+  Update the free state of the cluster in the free cluster bitmap of the volume.
+
+  @param  Volume                - FAT file system volume.
+  @param  Index                 - The index of the cluster.
+  @param  Free                  - TRUE if the cluster becomes free.
+
+**/
+STATIC
+VOID
+FatUpdateFreeClusterBitmap (
+  IN FAT_VOLUME       *Volume,
+  IN UINTN            Index,
+  IN BOOLEAN          Free
+  )
+{
+  if (Volume->FreeClusterBitmap == NULL || Index > (Volume->MaxCluster + 1)) {
+    return;
+  }
+
+  if (Free) {
+    Volume->FreeClusterBitmap[Index / 8] |= (UINT8) (1 << (Index % 8));
+  } else {
+    Volume->FreeClusterBitmap[Index / 8] &= (UINT8) ~(1 << (Index % 8));
+  }
+}
+
+/**
+
+  Build the free cluster bitmap of the volume by scanning the whole FAT once,
+  and update the free cluster count with the result. FAT16 and FAT32 entries
+  are read in blocks rather than one by one through FatGetFatEntry ().
+
+  If the bitmap can not be allocated or the FAT can not be read, the bitmap is
+  left NULL and the callers fall back to scan the FAT entries.
+
+  @param  Volume                - FAT file system volume.
+
+**/
+STATIC
+VOID
+FatBuildFreeClusterBitmap (
+  IN FAT_VOLUME       *Volume
+  )
+{
+  UINT8       *Bitmap;
+  UINT32      Buffer[FAT_BITMAP_READ_ENTRIES];
+  UINT16      *En16;
+  UINTN       ClusterCount;
+  UINTN       FreeCount;
+  UINTN       FirstFree;
+  UINTN       Index;
+  UINTN       Entry;
+  UINTN       Entries;
+  UINTN       Value;
+  EFI_STATUS  Status;
+
+  if (Volume->FreeClusterBitmap != NULL || Volume->DiskError) {
+    return;
+  }
+
+  ClusterCount = Volume->MaxCluster + 2;
+  Bitmap       = AllocateZeroPool ((ClusterCount + 7) / 8);
+  if (Bitmap == NULL) {
+    return;
+  }
+
+  Status    = EFI_SUCCESS;
+  FreeCount = 0;
+  FirstFree = ClusterCount;
+  if (Volume->FatType == Fat12) {
+    for (Index = FAT_MIN_CLUSTER; Index < ClusterCount && !Volume->DiskError; Index++) {
+      if (FatGetFatEntry (Volume, Index) == FAT_CLUSTER_FREE) {
+        Bitmap[Index / 8] |= (UINT8) (1 << (Index % 8));
+        FirstFree = MIN (FirstFree, Index);
+        FreeCount++;
+      }
+    }
+  } else {
+    En16 = (UINT16 *) Buffer;
+    for (Index = 0; Index < ClusterCount; Index += Entries) {
+      Entries = MIN (ClusterCount - Index, FAT_BITMAP_READ_ENTRIES);
+      Status  = FatDiskIo (
+                  Volume,
+                  ReadFat,
+                  Volume->FatPos + Index * Volume->FatEntrySize,
+                  Entries * Volume->FatEntrySize,
+                  Buffer,
+                  NULL
+                  );
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+
+      for (Entry = 0; Entry < Entries; Entry++) {
+        if (Volume->FatType == Fat16) {
+          Value = En16[Entry];
+        } else {
+          Value = Buffer[Entry] & FAT_CLUSTER_MASK_FAT32;
+        }
+
+        if (Value == FAT_CLUSTER_FREE && Index + Entry >= FAT_MIN_CLUSTER) {
+          Bitmap[(Index + Entry) / 8] |= (UINT8) (1 << ((Index + Entry) % 8));
+          FirstFree = MIN (FirstFree, Index + Entry);
+          FreeCount++;
+        }
+      }
+    }
+  }
+
+  if (EFI_ERROR (Status) || Volume->DiskError) {
+    FreePool (Bitmap);
+    return;
+  }
+
+  //
+  // Like FatComputeFreeInfo (), restart from the first free cluster if the
+  // hint has run past the end of the FAT
+  //
+  if (Volume->FatInfoSector.FreeInfo.NextCluster > (Volume->MaxCluster + 1)) {
+    Volume->FatInfoSector.FreeInfo.NextCluster = (UINT32) FirstFree;
+  }
+
+  Volume->FreeClusterBitmap                    = Bitmap;
+  Volume->FreeInfoValid                        = TRUE;
+  Volume->FatInfoSector.FreeInfo.ClusterCount  = (UINT32) FreeCount;
+  Volume->FatInfoSector.Signature              = FAT_INFO_SIGNATURE;
+  Volume->FatInfoSector.InfoBeginSignature     = FAT_INFO_BEGIN_SIGNATURE;
+  Volume->FatInfoSector.InfoEndSignature       = FAT_INFO_END_SIGNATURE;
+}
+
 /**
 
   Set the FAT entry value of the volume, which is identified with the Index.
@@ -160,10 +292,12 @@ FatSetFatEntry (
     if (Index < Volume->FatInfoSector.FreeInfo.NextCluster) {
       Volume->FatInfoSector.FreeInfo.NextCluster = (UINT32) Index;
     }
+    FatUpdateFreeClusterBitmap (Volume, Index, TRUE);
   } else if (Value != FAT_CLUSTER_FREE && OriginalVal == FAT_CLUSTER_FREE) {
     if (Volume->FatInfoSector.FreeInfo.ClusterCount != 0) {
       Volume->FatInfoSector.FreeInfo.ClusterCount -= 1;
     }
+    FatUpdateFreeClusterBitmap (Volume, Index, FALSE);
   }
   //
   // Make sure the entry is in memory
@@ -258,20 +392,73 @@ FatFreeClusters (
 
 /**
 
-  Allocate a free cluster and return the cluster index.
+  Find the first free cluster at or after Start in the free cluster bitmap.
+
+  @param  Volume                - FAT file system volume.
+  @param  Start                 - The cluster to start the search from.
+  @param  End                   - The cluster to stop the search before.
+
+  @return The index of the free cluster, or End if there is no free cluster.
+
+**/
+STATIC
+UINTN
+FatFindFreeCluster (
+  IN FAT_VOLUME   *Volume,
+  IN UINTN        Start,
+  IN UINTN        End
+  )
+{
+  UINT8 *Bitmap;
+  UINTN Cluster;
+
+  Bitmap  = Volume->FreeClusterBitmap;
+  Cluster = Start;
+  while (Cluster < End) {
+    //
+    // Skip 8 allocated clusters at a time
+    //
+    if ((Cluster % 8) == 0 && Bitmap[Cluster / 8] == 0) {
+      Cluster += 8;
+      continue;
+    }
+
+    if ((Bitmap[Cluster / 8] & (1 << (Cluster % 8))) != 0) {
+      return Cluster;
+    }
+
+    Cluster++;
+  }
+
+  return End;
+}
+
+/**
+
+  Allocate a run of consecutive free clusters and return the index of the
+  first cluster. The run ends at the first allocated cluster or when
+  MaxCount clusters are found. The FAT entries of the clusters are not
+  updated, the caller must chain them before allocating more clusters.
 
   @param  Volume                - FAT file system volume.
+  @param  MaxCount              - The max number of clusters to allocate.
+  @param  Count                 - The number of clusters allocated.
 
-  @return The index of the free cluster
+  @return The index of the first free cluster
 
 **/
 STATIC
 UINTN
-FatAllocateCluster (
-  IN FAT_VOLUME   *Volume
+FatAllocateClusters (
+  IN  FAT_VOLUME   *Volume,
+  IN  UINTN        MaxCount,
+  OUT UINTN        *Count
   )
 {
   UINTN Cluster;
+  UINTN End;
+
+  *Count = 0;
 
   //
   // Start looking at FatFreePos for the next unallocated cluster
@@ -280,6 +467,38 @@ FatAllocateCluster (
     return (UINTN) FAT_CLUSTER_LAST;
   }
 
+  FatBuildFreeClusterBitmap (Volume);
+  if (Volume->FreeClusterBitmap != NULL) {
+    //
+    // Search from the hint to the end of the FAT, then wrap around
+    //
+    End     = Volume->MaxCluster + 2;
+    Cluster = Volume->FatInfoSector.FreeInfo.NextCluster;
+    if (Cluster < FAT_MIN_CLUSTER || Cluster >= End) {
+      Cluster = FAT_MIN_CLUSTER;
+    }
+
+    Cluster = FatFindFreeCluster (Volume, Cluster, End);
+    if (Cluster == End) {
+      Cluster = FatFindFreeCluster (Volume, FAT_MIN_CLUSTER, End);
+      if (Cluster == End) {
+        return (UINTN) FAT_CLUSTER_LAST;
+      }
+    }
+
+    //
+    // Extend the run as long as the following clusters are free
+    //
+    *Count = 1;
+    while (*Count < MaxCount && Cluster + *Count < End &&
+           (Volume->FreeClusterBitmap[(Cluster + *Count) / 8] & (1 << ((Cluster + *Count) % 8))) != 0) {
+      *Count += 1;
+    }
+
+    Volume->FatInfoSector.FreeInfo.NextCluster = (UINT32) (Cluster + *Count);
+    return Cluster;
+  }
+
   for (;;) {
     //
     // If the end of the list, return no available cluster
@@ -307,6 +526,7 @@ FatAllocateCluster (
 
   Cluster = Volume->FatInfoSector.FreeInfo.NextCluster;
   Volume->FatInfoSector.FreeInfo.NextCluster += 1;
+  *Count = 1;
   return Cluster;
 }
 
@@ -436,6 +656,8 @@ FatGrowEof (
   UINTN       LastCluster;
   UINTN       NewCluster;
   UINTN       ClusterCount;
+  UINTN       RunCount;
+  UINTN       Index;
 
   //
   // For FAT file system, the max file is 4GB.
@@ -492,7 +714,7 @@ FatGrowEof (
     LastCluster = OFile->FileLastCluster;
 
     while (CurSize < NewSize) {
-      NewCluster = FatAllocateCluster (Volume);
+      NewCluster = FatAllocateClusters (Volume, NewSize - CurSize, &RunCount);
       if (FAT_END_OF_FAT_CHAIN (NewCluster)) {
         if (LastCluster != FAT_CLUSTER_FREE) {
           FatSetFatEntry (Volume, LastCluster, (UINTN) FAT_CLUSTER_LAST);
@@ -503,7 +725,7 @@ FatGrowEof (
         goto Done;
       }
 
-      if (NewCluster < FAT_MIN_CLUSTER || NewCluster > Volume->MaxCluster + 1) {
+      if (NewCluster < FAT_MIN_CLUSTER || NewCluster + RunCount - 1 > Volume->MaxCluster + 1) {
         Status = EFI_VOLUME_CORRUPTED;
         goto Done;
       }
@@ -515,19 +737,27 @@ FatGrowEof (
         OFile->FileCurrentCluster = NewCluster;
       }
 
-      LastCluster = NewCluster;
-      CurSize += 1;
+      //
+      // Chain the consecutive clusters of the run, their FAT entries are
+      // next to each other so they are usually in the same FAT cache page
+      //
+      for (Index = NewCluster; Index < NewCluster + RunCount - 1; Index++) {
+        FatSetFatEntry (Volume, Index, Index + 1);
+      }
+
+      LastCluster = NewCluster + RunCount - 1;
+      CurSize += RunCount;
 
       //
       // Terminate the cluster list
       //
-      // Note that we must do this EVERY time we allocate a cluster, because
-      // FatAllocateCluster scans the FAT looking for a free cluster and
-      // "LastCluster" is no longer free!  Usually, FatAllocateCluster will
-      // start looking with the cluster after "LastCluster"; however, when
-      // there is only one free cluster left, it will find "LastCluster"
-      // a second time.  There are other, less predictable scenarios
-      // where this could happen, as well.
+      // Note that we must do this EVERY time we allocate clusters, because
+      // FatAllocateClusters looks for free clusters and "LastCluster" is
+      // no longer free!  Usually, FatAllocateClusters will start looking
+      // with the cluster after "LastCluster"; however, when there is only
+      // one free cluster left, it will find "LastCluster" a second time.
+      // There are other, less predictable scenarios where this could
+      // happen, as well.
       //
       FatSetFatEntry (Volume, LastCluster, (UINTN) FAT_CLUSTER_LAST);
       OFile->FileLastCluster = LastCluster;
@@ -720,8 +950,13 @@ FatComputeFreeInfo (
   UINTN Index;
 
   //
-  // If we don't have valid info, compute it now
+  // If we don't have valid info, compute it now. Building the free
+  // cluster bitmap computes the info as well.
   //
+  if (!Volume->FreeInfoValid) {
+    FatBuildFreeClusterBitmap (Volume);
+  }
+
   if (!Volume->FreeInfoValid) {
 
     Volume->FreeInfoValid                        = TRUE;
@@ -10,11 +10,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 /**
 
-  Get hash value for long name.
+  Get hash value for long name. The name is upper-cased first, so the names
+  which only differ in case have the same hash value.
 
   @param  LongNameString        - The long name string to be hashed.
 
-  @return HashValue.
+  @return HashValue, use HASH_TABLE_MASK to get the index of hash table.
 
 **/
 STATIC
@@ -33,7 +34,7 @@ FatHashLongName (
     );
   FatStrUpr (UpCasedLongFileName);
   gBS->CalculateCrc32 (UpCasedLongFileName, StrSize (UpCasedLongFileName), &HashValue);
-  return (HashValue & HASH_TABLE_MASK);
+  return HashValue;
 }
 
 /**
@@ -73,11 +74,18 @@ FatLongNameHashSearch (
   )
 {
   FAT_DIRENT  **PreviousHashNode;
-  for (PreviousHashNode   = &ODir->LongNameHashTable[FatHashLongName (LongNameString)];
+  UINT32      HashValue;
+
+  HashValue = FatHashLongName (LongNameString);
+  for (PreviousHashNode   = &ODir->LongNameHashTable[HashValue & HASH_TABLE_MASK];
        *PreviousHashNode != NULL;
        PreviousHashNode   = &(*PreviousHashNode)->LongNameForwardLink
       ) {
-    if (FatStriCmp (LongNameString, (*PreviousHashNode)->FileString) == 0) {
+    //
+    // Only compare the names with the same full hash value
+    //
+    if ((*PreviousHashNode)->LongNameHash == HashValue &&
+        FatStriCmp (LongNameString, (*PreviousHashNode)->FileString) == 0) {
       break;
     }
   }
@@ -141,7 +149,8 @@ FatInsertToHashTable (
   //
   // Insert hash table index for long name
   //
-  HashTableIndex                = FatHashLongName (DirEnt->FileString);
+  DirEnt->LongNameHash          = FatHashLongName (DirEnt->FileString);
+  HashTableIndex                = DirEnt->LongNameHash & HASH_TABLE_MASK;
   HashTable                     = ODir->LongNameHashTable;
   DirEnt->LongNameForwardLink   = HashTable[HashTableIndex];
   HashTable[HashTableIndex]     = DirEnt;
@@ -161,6 +170,20 @@ FatDeleteFromHashTable (
   IN FAT_DIRENT   *DirEnt
   )
 {
+  FAT_DIRENT  **PreviousHashNode;
+
   *FatShortNameHashSearch (ODir, DirEnt->Entry.FileName) = DirEnt->ShortNameForwardLink;
-  *FatLongNameHashSearch (ODir, DirEnt->FileString)      = DirEnt->LongNameForwardLink;
+  //
+  // The long name hash is saved in the entry, so find the entry itself in the
+  // chain without hashing and comparing the name again
+  //
+  for (PreviousHashNode   = &ODir->LongNameHashTable[DirEnt->LongNameHash & HASH_TABLE_MASK];
+       *PreviousHashNode != NULL;
+       PreviousHashNode   = &(*PreviousHashNode)->LongNameForwardLink
+      ) {
+    if (*PreviousHashNode == DirEnt) {
+      *PreviousHashNode = DirEnt->LongNameForwardLink;
+      break;
+    }
+  }
 }
@@ -322,6 +322,7 @@ FatDiskIo (
   EFI_DISK_IO_PROTOCOL  *DiskIo;
   EFI_DISK_READ         IoFunction;
   FAT_SUBTASK           *Subtask;
+  FAT_SUBTASK           *LastSubtask;
 
   //
   // Verify the IO is in devices range
@@ -348,27 +349,48 @@ FatDiskIo (
         //
         // Non-blocking access
         //
-        Subtask = AllocateZeroPool (sizeof (*Subtask));
-        if (Subtask == NULL) {
-          Status        = EFI_OUT_OF_RESOURCES;
+
+        //
+        // Extend the last subtask when the access continues it both on disk and
+        // in memory, e.g. adjacent dirty cache pages, so that fewer Disk I/O 2
+        // requests and events are needed for the task.
+        //
+        LastSubtask = NULL;
+        if (!IsListEmpty (&Task->Subtasks)) {
+          LastSubtask = CR (GetPreviousNode (&Task->Subtasks, &Task->Subtasks), FAT_SUBTASK, Link, FAT_SUBTASK_SIGNATURE);
+          if ((LastSubtask->Write != (BOOLEAN) (IoMode == WriteDisk)) ||
+              (LastSubtask->Offset + LastSubtask->BufferSize != Offset) ||
+              ((UINT8 *) LastSubtask->Buffer + LastSubtask->BufferSize != (UINT8 *) Buffer)) {
+            LastSubtask = NULL;
+          }
+        }
+
+        if (LastSubtask != NULL) {
+          LastSubtask->BufferSize += BufferSize;
+          Status = EFI_SUCCESS;
         } else {
-          Subtask->Signature  = FAT_SUBTASK_SIGNATURE;
-          Subtask->Task       = Task;
-          Subtask->Write      = (BOOLEAN) (IoMode == WriteDisk);
-          Subtask->Offset     = Offset;
-          Subtask->Buffer     = Buffer;
-          Subtask->BufferSize = BufferSize;
-          Status = gBS->CreateEvent (
-                          EVT_NOTIFY_SIGNAL,
-                          TPL_NOTIFY,
-                          FatOnAccessComplete,
-                          Subtask,
-                          &Subtask->DiskIo2Token.Event
-                          );
-          if (!EFI_ERROR (Status)) {
-            InsertTailList (&Task->Subtasks, &Subtask->Link);
+          Subtask = AllocateZeroPool (sizeof (*Subtask));
+          if (Subtask == NULL) {
+            Status        = EFI_OUT_OF_RESOURCES;
           } else {
-            FreePool (Subtask);
+            Subtask->Signature  = FAT_SUBTASK_SIGNATURE;
+            Subtask->Task       = Task;
+            Subtask->Write      = (BOOLEAN) (IoMode == WriteDisk);
+            Subtask->Offset     = Offset;
+            Subtask->Buffer     = Buffer;
+            Subtask->BufferSize = BufferSize;
+            Status = gBS->CreateEvent (
+                            EVT_NOTIFY_SIGNAL,
+                            TPL_NOTIFY,
+                            FatOnAccessComplete,
+                            Subtask,
+                            &Subtask->DiskIo2Token.Event
+                            );
+            if (!EFI_ERROR (Status)) {
+              InsertTailList (&Task->Subtasks, &Subtask->Link);
+            } else {
+              FreePool (Subtask);
+            }
           }
         }
       }
@@ -465,6 +487,12 @@ FatFreeVolume (
     FreePool (Volume->CacheBuffer);
   }
   //
+  // Free free cluster bitmap
+  //
+  if (Volume->FreeClusterBitmap != NULL) {
+    FreePool (Volume->FreeClusterBitmap);
+  }
+  //
   // Free directory cache
   //
   FatCleanupODirCache (Volume);
@@ -0,0 +1,159 @@
+/** @file
+  Shell application that prints the usage of the DXE Core pool allocator for
+  each memory type and pool size class, as reported by the Pool Statistics
+  Protocol.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiApplicationEntryPoint.h>
+#include <Library/BaseLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include <Protocol/PoolStatistics.h>
+
+CHAR16 *mMemoryTypeString[] = {
+  L"EfiReservedMemoryType",
+  L"EfiLoaderCode",
+  L"EfiLoaderData",
+  L"EfiBootServicesCode",
+  L"EfiBootServicesData",
+  L"EfiRuntimeServicesCode",
+  L"EfiRuntimeServicesData",
+  L"EfiConventionalMemory",
+  L"EfiUnusableMemory",
+  L"EfiACPIReclaimMemory",
+  L"EfiACPIMemoryNVS",
+  L"EfiMemoryMappedIO",
+  L"EfiMemoryMappedIOPortSpace",
+  L"EfiPalCode",
+  L"EfiPersistentMemory",
+};
+
+/**
+  Print the pool usage of one memory type.
+
+  @param[in] PoolStatistics   The Pool Statistics Protocol instance.
+  @param[in] MemoryType       The memory type to print.
+  @param[in] ClassCount       The number of pool size classes.
+  @param[in] ClassStatistics  Buffer for ClassCount entries.
+
+**/
+VOID
+PrintPoolStatistics (
+  IN EDKII_POOL_STATISTICS_PROTOCOL  *PoolStatistics,
+  IN EFI_MEMORY_TYPE                 MemoryType,
+  IN UINTN                           ClassCount,
+  IN EDKII_POOL_CLASS_STATISTICS     *ClassStatistics
+  )
+{
+  EFI_STATUS                   Status;
+  UINT64                       PoolPages;
+  UINT64                       LiveBytes;
+  UINT64                       WastedBytes;
+  UINTN                        Index;
+  EDKII_POOL_CLASS_STATISTICS  *Class;
+
+  Status = PoolStatistics->GetStatistics (
+                             PoolStatistics,
+                             MemoryType,
+                             &ClassCount,
+                             ClassStatistics,
+                             &PoolPages
+                             );
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  LiveBytes   = 0;
+  WastedBytes = 0;
+  for (Index = 0; Index < ClassCount; Index++) {
+    LiveBytes   += ClassStatistics[Index].LiveBytes;
+    WastedBytes += ClassStatistics[Index].WastedBytes;
+  }
+  if ((LiveBytes == 0) && (PoolPages == 0)) {
+    return;
+  }
+
+  Print (
+    L"%s: %ld bytes live, %ld bytes waste, %ld pool pages\n",
+    mMemoryTypeString[MemoryType],
+    LiveBytes,
+    WastedBytes,
+    PoolPages
+    );
+  Print (L"  BlockSize  LiveBlocks   LiveBytes WastedBytes  FreeBlocks TotalAllocs\n");
+  for (Index = 0; Index < ClassCount; Index++) {
+    Class = &ClassStatistics[Index];
+    if ((Class->TotalAllocations == 0) && (Class->FreeBlocks == 0)) {
+      continue;
+    }
+    if (Class->BlockSize == 0) {
+      Print (L"      pages");
+    } else {
+      Print (L"  %9ld", Class->BlockSize);
+    }
+    Print (
+      L" %11ld %11ld %11ld %11ld %11ld\n",
+      Class->LiveBlocks,
+      Class->LiveBytes,
+      Class->WastedBytes,
+      Class->FreeBlocks,
+      Class->TotalAllocations
+      );
+  }
+}
+
+/**
+  The user Entry Point for Application. The user code starts with this function
+  as the real entry point for the image goes into a library that calls this function.
+
+  @param[in] ImageHandle    The firmware allocated handle for the EFI image.
+  @param[in] SystemTable    A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS       The entry point is executed successfully.
+  @retval other             Some error occurs when executing this entry point.
+
+**/
+EFI_STATUS
+EFIAPI
+UefiMain (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS                      Status;
+  EDKII_POOL_STATISTICS_PROTOCOL  *PoolStatistics;
+  EDKII_POOL_CLASS_STATISTICS     *ClassStatistics;
+  UINTN                           ClassCount;
+  UINTN                           Type;
+
+  Status = gBS->LocateProtocol (&gEdkiiPoolStatisticsProtocolGuid, NULL, (VOID **) &PoolStatistics);
+  if (EFI_ERROR (Status)) {
+    Print (L"PoolStatisticsInfo: Locate Pool Statistics Protocol - %r\n", Status);
+    return Status;
+  }
+
+  ClassCount = 0;
+  Status = PoolStatistics->GetStatistics (PoolStatistics, EfiBootServicesData, &ClassCount, NULL, NULL);
+  if (Status != EFI_BUFFER_TOO_SMALL) {
+    Print (L"PoolStatisticsInfo: GetStatistics - %r\n", Status);
+    return Status;
+  }
+
+  ClassStatistics = AllocatePool (ClassCount * sizeof (EDKII_POOL_CLASS_STATISTICS));
+  if (ClassStatistics == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Type = 0; Type < ARRAY_SIZE (mMemoryTypeString); Type++) {
+    PrintPoolStatistics (PoolStatistics, (EFI_MEMORY_TYPE) Type, ClassCount, ClassStatistics);
+  }
+
+  FreePool (ClassStatistics);
+  return EFI_SUCCESS;
+}
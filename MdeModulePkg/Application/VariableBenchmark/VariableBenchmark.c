@@ -0,0 +1,218 @@
+/** @file
+  Shell application that measures the latency of the variable services.
+
+  A set of volatile boot service variables is created under the GUID of the
+  application, read back, looked up by names that do not exist, updated, enumerated
+  with GetNextVariableName () and finally deleted. The average time of each
+  kind of call is printed, so that the cost of the variable store lookups can
+  be compared between firmware builds.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiApplicationEntryPoint.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrintLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+
+#define VARIABLE_BENCHMARK_COUNT      256
+#define VARIABLE_BENCHMARK_DATA_SIZE  16
+#define VARIABLE_BENCHMARK_NAME_SIZE  32
+
+/**
+  Print the average time of a set of calls.
+
+  @param[in] Operation    The name of the measured call.
+  @param[in] StartTicks   The performance counter before the calls.
+  @param[in] EndTicks     The performance counter after the calls.
+  @param[in] Count        The number of calls.
+
+**/
+VOID
+PrintLatency (
+  IN CHAR16  *Operation,
+  IN UINT64  StartTicks,
+  IN UINT64  EndTicks,
+  IN UINTN   Count
+  )
+{
+  UINT64  StartValue;
+  UINT64  EndValue;
+  UINT64  Ticks;
+  UINT64  NanoSeconds;
+
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+  if (EndValue >= StartValue) {
+    Ticks = EndTicks - StartTicks;
+  } else {
+    Ticks = StartTicks - EndTicks;
+  }
+
+  NanoSeconds = GetTimeInNanoSecond (Ticks);
+  Print (
+    L"%-24s %6d calls  %10ld ns total  %8ld ns/call\n",
+    Operation,
+    Count,
+    NanoSeconds,
+    (Count == 0) ? 0 : DivU64x32 (NanoSeconds, (UINT32) Count)
+    );
+}
+
+/**
+  Build the name of a benchmark variable.
+
+  @param[out] Name      Buffer of VARIABLE_BENCHMARK_NAME_SIZE bytes for the name.
+  @param[in]  Prefix    The prefix of the name.
+  @param[in]  Index     The number of the variable.
+
+**/
+VOID
+GetBenchmarkVariableName (
+  OUT CHAR16  *Name,
+  IN  CHAR16  *Prefix,
+  IN  UINTN   Index
+  )
+{
+  UnicodeSPrint (Name, VARIABLE_BENCHMARK_NAME_SIZE, L"%s%04x", Prefix, Index);
+}
+
+/**
+  The user Entry Point for Application. The user code starts with this function
+  as the real entry point for the application.
+
+  @param[in] ImageHandle    The firmware allocated handle for the EFI image.
+  @param[in] SystemTable    A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS       The entry point is executed successfully.
+  @retval other             Some error occurs when executing this entry point.
+
+**/
+EFI_STATUS
+EFIAPI
+UefiMain (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS  Status;
+  CHAR16      Name[VARIABLE_BENCHMARK_NAME_SIZE / sizeof (CHAR16)];
+  UINT8       Data[VARIABLE_BENCHMARK_DATA_SIZE];
+  UINTN       DataSize;
+  UINTN       Index;
+  UINTN       Count;
+  UINT64      StartTicks;
+  UINT64      EndTicks;
+  CHAR16      *NextName;
+  UINTN       NextNameBufferSize;
+  UINTN       NextNameSize;
+  EFI_GUID    NextGuid;
+  CHAR16      *NewBuffer;
+  UINT32      Attributes;
+
+  Attributes = EFI_VARIABLE_BOOTSERVICE_ACCESS;
+  SetMem (Data, sizeof (Data), 0x5A);
+
+  //
+  // Create the variables.
+  //
+  Count      = 0;
+  StartTicks = GetPerformanceCounter ();
+  for (Index = 0; Index < VARIABLE_BENCHMARK_COUNT; Index++) {
+    GetBenchmarkVariableName (Name, L"Bench", Index);
+    Status = gRT->SetVariable (Name, &gEfiCallerIdGuid, Attributes, sizeof (Data), Data);
+    if (EFI_ERROR (Status)) {
+      Print (L"VariableBenchmark: Failed to create %s - %r\n", Name, Status);
+      break;
+    }
+    Count++;
+  }
+  EndTicks = GetPerformanceCounter ();
+  PrintLatency (L"SetVariable (create)", StartTicks, EndTicks, Count);
+
+  //
+  // Read back the existing variables.
+  //
+  StartTicks = GetPerformanceCounter ();
+  for (Index = 0; Index < Count; Index++) {
+    GetBenchmarkVariableName (Name, L"Bench", Index);
+    DataSize = sizeof (Data);
+    gRT->GetVariable (Name, &gEfiCallerIdGuid, NULL, &DataSize, Data);
+  }
+  EndTicks = GetPerformanceCounter ();
+  PrintLatency (L"GetVariable (found)", StartTicks, EndTicks, Count);
+
+  //
+  // Look up variables that do not exist, which walks all the variable stores.
+  //
+  StartTicks = GetPerformanceCounter ();
+  for (Index = 0; Index < VARIABLE_BENCHMARK_COUNT; Index++) {
+    GetBenchmarkVariableName (Name, L"Absent", Index);
+    DataSize = sizeof (Data);
+    gRT->GetVariable (Name, &gEfiCallerIdGuid, NULL, &DataSize, Data);
+  }
+  EndTicks = GetPerformanceCounter ();
+  PrintLatency (L"GetVariable (not found)", StartTicks, EndTicks, VARIABLE_BENCHMARK_COUNT);
+
+  //
+  // Update the variables with new data of the same size.
+  //
+  SetMem (Data, sizeof (Data), 0xA5);
+  StartTicks = GetPerformanceCounter ();
+  for (Index = 0; Index < Count; Index++) {
+    GetBenchmarkVariableName (Name, L"Bench", Index);
+    gRT->SetVariable (Name, &gEfiCallerIdGuid, Attributes, sizeof (Data), Data);
+  }
+  EndTicks = GetPerformanceCounter ();
+  PrintLatency (L"SetVariable (update)", StartTicks, EndTicks, Count);
+
+  //
+  // Enumerate all the variables of the system.
+  //
+  NextNameBufferSize = VARIABLE_BENCHMARK_NAME_SIZE;
+  NextName           = AllocateZeroPool (NextNameBufferSize);
+  if (NextName == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+  } else {
+    Index      = 0;
+    StartTicks = GetPerformanceCounter ();
+    while (TRUE) {
+      NextNameSize = NextNameBufferSize;
+      Status = gRT->GetNextVariableName (&NextNameSize, NextName, &NextGuid);
+      if (Status == EFI_BUFFER_TOO_SMALL) {
+        NewBuffer = ReallocatePool (NextNameBufferSize, NextNameSize, NextName);
+        if (NewBuffer == NULL) {
+          break;
+        }
+        NextName           = NewBuffer;
+        NextNameBufferSize = NextNameSize;
+        Status = gRT->GetNextVariableName (&NextNameSize, NextName, &NextGuid);
+      }
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+      Index++;
+    }
+    EndTicks = GetPerformanceCounter ();
+    PrintLatency (L"GetNextVariableName", StartTicks, EndTicks, Index);
+    FreePool (NextName);
+  }
+
+  //
+  // Delete the variables.
+  //
+  StartTicks = GetPerformanceCounter ();
+  for (Index = 0; Index < Count; Index++) {
+    GetBenchmarkVariableName (Name, L"Bench", Index);
+    gRT->SetVariable (Name, &gEfiCallerIdGuid, Attributes, 0, NULL);
+  }
+  EndTicks = GetPerformanceCounter ();
+  PrintLatency (L"SetVariable (delete)", StartTicks, EndTicks, Count);
+
+  return EFI_SUCCESS;
+}
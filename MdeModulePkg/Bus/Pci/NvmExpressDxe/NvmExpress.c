@@ -545,76 +545,9 @@ ProcessAsyncTaskList (
   PciIo      = Private->PciIo;
 
   //
-  // Submit asynchronous subtasks to the NVMe Submission Queue
+  // Reap the completed commands first, so that the submission queue entries
+  // they free can be refilled by the unsubmitted subtasks below.
   //
-  for (Link = GetFirstNode (&Private->UnsubmittedSubtasks);
-       !IsNull (&Private->UnsubmittedSubtasks, Link);
-       Link = NextLink) {
-    NextLink      = GetNextNode (&Private->UnsubmittedSubtasks, Link);
-    Subtask       = NVME_BLKIO2_SUBTASK_FROM_LINK (Link);
-    BlkIo2Request = Subtask->BlockIo2Request;
-    Token         = BlkIo2Request->Token;
-    RemoveEntryList (Link);
-    BlkIo2Request->UnsubmittedSubtaskNum--;
-
-    //
-    // If any previous subtask fails, do not process subsequent ones.
-    //
-    if (Token->TransactionStatus != EFI_SUCCESS) {
-      if (IsListEmpty (&BlkIo2Request->SubtasksQueue) &&
-          BlkIo2Request->LastSubtaskSubmitted &&
-          (BlkIo2Request->UnsubmittedSubtaskNum == 0)) {
-        //
-        // Remove the BlockIo2 request from the device asynchronous queue.
-        //
-        RemoveEntryList (&BlkIo2Request->Link);
-        FreePool (BlkIo2Request);
-        gBS->SignalEvent (Token->Event);
-      }
-
-      FreePool (Subtask->CommandPacket->NvmeCmd);
-      FreePool (Subtask->CommandPacket->NvmeCompletion);
-      FreePool (Subtask->CommandPacket);
-      FreePool (Subtask);
-
-      continue;
-    }
-
-    Status = Private->Passthru.PassThru (
-                                 &Private->Passthru,
-                                 Subtask->NamespaceId,
-                                 Subtask->CommandPacket,
-                                 Subtask->Event
-                                 );
-    if (Status == EFI_NOT_READY) {
-      InsertHeadList (&Private->UnsubmittedSubtasks, Link);
-      BlkIo2Request->UnsubmittedSubtaskNum++;
-      break;
-    } else if (EFI_ERROR (Status)) {
-      Token->TransactionStatus = EFI_DEVICE_ERROR;
-
-      if (IsListEmpty (&BlkIo2Request->SubtasksQueue) &&
-          Subtask->IsLast) {
-        //
-        // Remove the BlockIo2 request from the device asynchronous queue.
-        //
-        RemoveEntryList (&BlkIo2Request->Link);
-        FreePool (BlkIo2Request);
-        gBS->SignalEvent (Token->Event);
-      }
-
-      FreePool (Subtask->CommandPacket->NvmeCmd);
-      FreePool (Subtask->CommandPacket->NvmeCompletion);
-      FreePool (Subtask->CommandPacket);
-      FreePool (Subtask);
-    } else {
-      InsertTailList (&BlkIo2Request->SubtasksQueue, Link);
-      if (Subtask->IsLast) {
-        BlkIo2Request->LastSubtaskSubmitted = TRUE;
-      }
-    }
-  }
-
   while (Cq->Pt != Private->Pt[QueueId]) {
     ASSERT (Cq->Sqid == QueueId);
 
@@ -691,6 +624,77 @@ ProcessAsyncTaskList (
                  &Data
                  );
   }
+
+  //
+  // Submit asynchronous subtasks to the NVMe Submission Queue
+  //
+  for (Link = GetFirstNode (&Private->UnsubmittedSubtasks);
+       !IsNull (&Private->UnsubmittedSubtasks, Link);
+       Link = NextLink) {
+    NextLink      = GetNextNode (&Private->UnsubmittedSubtasks, Link);
+    Subtask       = NVME_BLKIO2_SUBTASK_FROM_LINK (Link);
+    BlkIo2Request = Subtask->BlockIo2Request;
+    Token         = BlkIo2Request->Token;
+    RemoveEntryList (Link);
+    BlkIo2Request->UnsubmittedSubtaskNum--;
+
+    //
+    // If any previous subtask fails, do not process subsequent ones.
+    //
+    if (Token->TransactionStatus != EFI_SUCCESS) {
+      if (IsListEmpty (&BlkIo2Request->SubtasksQueue) &&
+          BlkIo2Request->LastSubtaskSubmitted &&
+          (BlkIo2Request->UnsubmittedSubtaskNum == 0)) {
+        //
+        // Remove the BlockIo2 request from the device asynchronous queue.
+        //
+        RemoveEntryList (&BlkIo2Request->Link);
+        FreePool (BlkIo2Request);
+        gBS->SignalEvent (Token->Event);
+      }
+
+      FreePool (Subtask->CommandPacket->NvmeCmd);
+      FreePool (Subtask->CommandPacket->NvmeCompletion);
+      FreePool (Subtask->CommandPacket);
+      FreePool (Subtask);
+
+      continue;
+    }
+
+    Status = Private->Passthru.PassThru (
+                                 &Private->Passthru,
+                                 Subtask->NamespaceId,
+                                 Subtask->CommandPacket,
+                                 Subtask->Event
+                                 );
+    if (Status == EFI_NOT_READY) {
+      InsertHeadList (&Private->UnsubmittedSubtasks, Link);
+      BlkIo2Request->UnsubmittedSubtaskNum++;
+      break;
+    } else if (EFI_ERROR (Status)) {
+      Token->TransactionStatus = EFI_DEVICE_ERROR;
+
+      if (IsListEmpty (&BlkIo2Request->SubtasksQueue) &&
+          Subtask->IsLast) {
+        //
+        // Remove the BlockIo2 request from the device asynchronous queue.
+        //
+        RemoveEntryList (&BlkIo2Request->Link);
+        FreePool (BlkIo2Request);
+        gBS->SignalEvent (Token->Event);
+      }
+
+      FreePool (Subtask->CommandPacket->NvmeCmd);
+      FreePool (Subtask->CommandPacket->NvmeCompletion);
+      FreePool (Subtask->CommandPacket);
+      FreePool (Subtask);
+    } else {
+      InsertTailList (&BlkIo2Request->SubtasksQueue, Link);
+      if (Subtask->IsLast) {
+        BlkIo2Request->LastSubtaskSubmitted = TRUE;
+      }
+    }
+  }
 }
 
 /**
@@ -195,21 +195,17 @@ NvmeRead (
     MaxTransferBlocks = 1024;
   }
 
-  while (Blocks > 0) {
-    if (Blocks > MaxTransferBlocks) {
-      Status = ReadSectors (Device, (UINT64)(UINTN)Buffer, Lba, MaxTransferBlocks);
-
-      Blocks -= MaxTransferBlocks;
-      Buffer  = (VOID *)(UINTN)((UINT64)(UINTN)Buffer + MaxTransferBlocks * BlockSize);
-      Lba    += MaxTransferBlocks;
-    } else {
-      Status = ReadSectors (Device, (UINT64)(UINTN)Buffer, Lba, (UINT32)Blocks);
-      Blocks = 0;
-    }
+  if (Blocks > MaxTransferBlocks) {
+    //
+    // Keep all the commands of a large transfer outstanding together.
+    //
+    Status = NvmeQueuedTransfer (Device, TRUE, Buffer, Lba, Blocks, MaxTransferBlocks);
+  } else {
+    Status = ReadSectors (Device, (UINT64)(UINTN)Buffer, Lba, (UINT32)Blocks);
+  }
 
-    if (EFI_ERROR(Status)) {
-      break;
-    }
+  if (!EFI_ERROR (Status)) {
+    Blocks = 0;
   }
 
   DEBUG ((DEBUG_BLKIO, "%a: Lba = 0x%08Lx, Original = 0x%08Lx, "
@@ -273,21 +269,17 @@ NvmeWrite (
     MaxTransferBlocks = 1024;
   }
 
-  while (Blocks > 0) {
-    if (Blocks > MaxTransferBlocks) {
-      Status = WriteSectors (Device, (UINT64)(UINTN)Buffer, Lba, MaxTransferBlocks);
-
-      Blocks -= MaxTransferBlocks;
-      Buffer  = (VOID *)(UINTN)((UINT64)(UINTN)Buffer + MaxTransferBlocks * BlockSize);
-      Lba    += MaxTransferBlocks;
-    } else {
-      Status = WriteSectors (Device, (UINT64)(UINTN)Buffer, Lba, (UINT32)Blocks);
-      Blocks = 0;
-    }
+  if (Blocks > MaxTransferBlocks) {
+    //
+    // Keep all the commands of a large transfer outstanding together.
+    //
+    Status = NvmeQueuedTransfer (Device, FALSE, Buffer, Lba, Blocks, MaxTransferBlocks);
+  } else {
+    Status = WriteSectors (Device, (UINT64)(UINTN)Buffer, Lba, (UINT32)Blocks);
+  }
 
-    if (EFI_ERROR(Status)) {
-      break;
-    }
+  if (!EFI_ERROR (Status)) {
+    Blocks = 0;
   }
 
   DEBUG ((DEBUG_BLKIO, "%a: Lba = 0x%08Lx, Original = 0x%08Lx, "
@@ -796,6 +788,13 @@ NvmeAsyncRead (
     }
   }
 
+  //
+  // Submit the subtasks now rather than on the next timer tick.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  ProcessAsyncTaskList (Private->TimerEvent, Private);
+  gBS->RestoreTPL (OldTpl);
+
   DEBUG ((DEBUG_BLKIO, "%a: Lba = 0x%08Lx, Original = 0x%08Lx, "
     "Remaining = 0x%08Lx, BlockSize = 0x%x, Status = %r\n", __FUNCTION__, Lba,
     (UINT64)OrginalBlocks, (UINT64)Blocks, BlockSize, Status));
@@ -916,6 +915,13 @@ NvmeAsyncWrite (
     }
   }
 
+  //
+  // Submit the subtasks now rather than on the next timer tick.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  ProcessAsyncTaskList (Private->TimerEvent, Private);
+  gBS->RestoreTPL (OldTpl);
+
   DEBUG ((DEBUG_BLKIO, "%a: Lba = 0x%08Lx, Original = 0x%08Lx, "
     "Remaining = 0x%08Lx, BlockSize = 0x%x, Status = %r\n", __FUNCTION__, Lba,
     (UINT64)OrginalBlocks, (UINT64)Blocks, BlockSize, Status));
@@ -923,6 +929,159 @@ NvmeAsyncWrite (
   return Status;
 }
 
+/**
+  Read or write some blocks through the asynchronous I/O queue, and wait for
+  the completion.
+
+  A transfer larger than the maximum data transfer size takes several commands.
+  Sending them through the asynchronous I/O queue keeps all of them outstanding
+  on the controller, instead of one command at a time on the synchronous I/O
+  queue.
+
+  @param  Device                 The pointer to the NVME_DEVICE_PRIVATE_DATA data structure.
+  @param  Read                   TRUE to read the blocks, FALSE to write them.
+  @param  Buffer                 The buffer of the data.
+  @param  Lba                    The start block number.
+  @param  Blocks                 Total block number to be transferred.
+  @param  MaxTransferBlocks      The maximum block number of one command.
+
+  @retval EFI_SUCCESS            Datum are transferred.
+  @retval EFI_TIMEOUT            The commands did not complete in time, the controller is reset.
+  @retval EFI_DEVICE_ERROR       The commands did not complete in time, and the controller
+                                 could not be reset or the commands could not be aborted.
+  @retval Others                 Fail to transfer all the datum.
+
+**/
+EFI_STATUS
+NvmeQueuedTransfer (
+  IN     NVME_DEVICE_PRIVATE_DATA       *Device,
+  IN     BOOLEAN                        Read,
+  IN OUT VOID                           *Buffer,
+  IN     UINT64                         Lba,
+  IN     UINTN                          Blocks,
+  IN     UINT32                         MaxTransferBlocks
+  )
+{
+  NVME_CONTROLLER_PRIVATE_DATA     *Private;
+  EFI_BLOCK_IO2_TOKEN              *Token;
+  EFI_EVENT                        TimerEvent;
+  EFI_STATUS                       Status;
+  EFI_TPL                          OldTpl;
+  BOOLEAN                          ControllerReset;
+
+  Private    = Device->Controller;
+  TimerEvent = NULL;
+
+  //
+  // The token is allocated rather than on the stack, so that it can be left
+  // to a request that could not be aborted.
+  //
+  Token = AllocateZeroPool (sizeof (EFI_BLOCK_IO2_TOKEN));
+  if (Token == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = gBS->CreateEvent (0, TPL_NOTIFY, NULL, NULL, &Token->Event);
+  if (EFI_ERROR (Status)) {
+    FreePool (Token);
+    return Status;
+  }
+
+  //
+  // Allow each command the same time as on the synchronous I/O queue.
+  //
+  Status = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL, &TimerEvent);
+  if (EFI_ERROR (Status)) {
+    goto EXIT;
+  }
+
+  Status = gBS->SetTimer (
+                  TimerEvent,
+                  TimerRelative,
+                  MultU64x32 (NVME_GENERIC_TIMEOUT, (UINT32) ((Blocks + MaxTransferBlocks - 1) / MaxTransferBlocks))
+                  );
+  if (EFI_ERROR (Status)) {
+    goto EXIT;
+  }
+
+  Token->TransactionStatus = EFI_SUCCESS;
+  if (Read) {
+    Status = NvmeAsyncRead (Device, Buffer, Lba, Blocks, Token);
+  } else {
+    Status = NvmeAsyncWrite (Device, Buffer, Lba, Blocks, Token);
+  }
+  if (EFI_ERROR (Status)) {
+    goto EXIT;
+  }
+
+  //
+  // Process the queue here rather than on the periodic timer, so that the
+  // entries freed by the completed commands are refilled at once.
+  //
+  while (gBS->CheckEvent (Token->Event) == EFI_NOT_READY) {
+    if (!EFI_ERROR (gBS->CheckEvent (TimerEvent))) {
+      DEBUG ((DEBUG_ERROR, "%a: Timeout occurs for the queued NVMe commands.\n", __FUNCTION__));
+
+      //
+      // Reset the controller and abort the outstanding commands, which signals
+      // the token. Aborting marks the unsubmitted commands EFI_ABORTED, so
+      // whether the controller is usable again is tracked separately.
+      //
+      gBS->SetTimer (Private->TimerEvent, TimerCancel, 0);
+
+      ControllerReset = TRUE;
+      Status = NvmeControllerInit (Private);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "%a: Fail to reset the controller - %r\n", __FUNCTION__, Status));
+        ControllerReset = FALSE;
+      }
+
+      Status = AbortAsyncPassThruTasks (Private);
+      if (EFI_ERROR (Status)) {
+        ControllerReset = FALSE;
+      }
+
+      //
+      // Only resume the processing of the asynchronous queue on a controller
+      // that has been reset.
+      //
+      if (ControllerReset) {
+        gBS->SetTimer (Private->TimerEvent, TimerPeriodic, NVME_HC_ASYNC_TIMER);
+        Token->TransactionStatus = EFI_TIMEOUT;
+      } else {
+        Token->TransactionStatus = EFI_DEVICE_ERROR;
+      }
+
+      if (gBS->CheckEvent (Token->Event) == EFI_NOT_READY) {
+        //
+        // The request could not be aborted and may still complete later, so
+        // the token is not freed.
+        //
+        DEBUG ((DEBUG_ERROR, "%a: Fail to abort the queued NVMe commands.\n", __FUNCTION__));
+        gBS->CloseEvent (TimerEvent);
+        return EFI_DEVICE_ERROR;
+      }
+
+      break;
+    }
+
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    ProcessAsyncTaskList (Private->TimerEvent, Private);
+    gBS->RestoreTPL (OldTpl);
+  }
+
+  Status = Token->TransactionStatus;
+
+EXIT:
+  if (TimerEvent != NULL) {
+    gBS->CloseEvent (TimerEvent);
+  }
+
+  gBS->CloseEvent (Token->Event);
+  FreePool (Token);
+  return Status;
+}
+
 /**
   Reset the Block Device.
 
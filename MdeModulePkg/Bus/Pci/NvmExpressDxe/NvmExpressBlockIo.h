@@ -408,4 +408,37 @@ NvmeStorageSecuritySendData (
   IN VOID                                     *PayloadBuffer
   );
 
+/**
+  Read or write some blocks through the asynchronous I/O queue, and wait for
+  the completion.
+
+  A transfer larger than the maximum data transfer size takes several commands.
+  Sending them through the asynchronous I/O queue keeps all of them outstanding
+  on the controller, instead of one command at a time on the synchronous I/O
+  queue.
+
+  @param  Device                 The pointer to the NVME_DEVICE_PRIVATE_DATA data structure.
+  @param  Read                   TRUE to read the blocks, FALSE to write them.
+  @param  Buffer                 The buffer of the data.
+  @param  Lba                    The start block number.
+  @param  Blocks                 Total block number to be transferred.
+  @param  MaxTransferBlocks      The maximum block number of one command.
+
+  @retval EFI_SUCCESS            Datum are transferred.
+  @retval EFI_TIMEOUT            The commands did not complete in time, the controller is reset.
+  @retval EFI_DEVICE_ERROR       The commands did not complete in time, and the controller
+                                 could not be reset or the commands could not be aborted.
+  @retval Others                 Fail to transfer all the datum.
+
+**/
+EFI_STATUS
+NvmeQueuedTransfer (
+  IN     NVME_DEVICE_PRIVATE_DATA       *Device,
+  IN     BOOLEAN                        Read,
+  IN OUT VOID                           *Buffer,
+  IN     UINT64                         Lba,
+  IN     UINTN                          Blocks,
+  IN     UINT32                         MaxTransferBlocks
+  );
+
 #endif
@@ -76,6 +76,72 @@ PciDevicePresent (
   return EFI_NOT_FOUND;
 }
 
+/**
+  Check whether only device 0 can be present on the secondary bus of a bridge.
+
+  A PCI Express root port or switch downstream port has a point-to-point link,
+  so the only device behind it is device 0, unless ARI forwarding is enabled
+  and the function numbers of an ARI device spill over into the device field.
+  Probing devices 1..31 on such a bus only costs config cycles that end in
+  unsupported requests.
+
+  @param Bridge         Parent bridge instance.
+
+  @retval TRUE          Only device 0 needs to be probed behind the bridge.
+  @retval FALSE         All the devices need to be probed behind the bridge.
+
+**/
+BOOLEAN
+PciBridgeHasSingleDevice (
+  IN PCI_IO_DEVICE                      *Bridge
+  )
+{
+  EFI_STATUS                   Status;
+  PCI_REG_PCIE_CAPABILITY      Capability;
+  UINT32                       DeviceControl2;
+
+  if (!Bridge->IsPciExp) {
+    return FALSE;
+  }
+
+  Status = Bridge->PciIo.Pci.Read (
+                               &Bridge->PciIo,
+                               EfiPciIoWidthUint16,
+                               Bridge->PciExpressCapabilityOffset + OFFSET_OF (PCI_CAPABILITY_PCIEXP, Capability),
+                               1,
+                               &Capability
+                               );
+  if (EFI_ERROR (Status)) {
+    return FALSE;
+  }
+
+  switch (Capability.Bits.DevicePortType) {
+  case PCIE_DEVICE_PORT_TYPE_ROOT_PORT:
+  case PCIE_DEVICE_PORT_TYPE_DOWNSTREAM_PORT:
+    break;
+  default:
+    return FALSE;
+  }
+
+  //
+  // ARI forwarding is enabled while device 0 behind the bridge is created,
+  // so the register must be checked after device 0 has been collected.
+  //
+  Status = Bridge->PciIo.Pci.Read (
+                               &Bridge->PciIo,
+                               EfiPciIoWidthUint32,
+                               Bridge->PciExpressCapabilityOffset + EFI_PCIE_CAPABILITY_DEVICE_CONTROL_2_OFFSET,
+                               1,
+                               &DeviceControl2
+                               );
+  if (EFI_ERROR (Status) ||
+      (DeviceControl2 & EFI_PCIE_CAPABILITY_DEVICE_CONTROL_2_ARI_FORWARDING) != 0) {
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
 /**
   Collect all the resource information under this root bridge.
 
@@ -108,6 +174,10 @@ PciPciDeviceInfoCollector (
 
   for (Device = 0; Device <= PCI_MAX_DEVICE; Device++) {
 
+    if (Device == 1 && PciBridgeHasSingleDevice (Bridge)) {
+      break;
+    }
+
     for (Func = 0; Func <= PCI_MAX_FUNC; Func++) {
 
       //
@@ -31,6 +31,20 @@ PciDevicePresent (
   IN  UINT8                               Func
   );
 
+/**
+  Check whether only device 0 can be present on the secondary bus of a bridge.
+
+  @param Bridge         Parent bridge instance.
+
+  @retval TRUE          Only device 0 needs to be probed behind the bridge.
+  @retval FALSE         All the devices need to be probed behind the bridge.
+
+**/
+BOOLEAN
+PciBridgeHasSingleDevice (
+  IN PCI_IO_DEVICE                      *Bridge
+  );
+
 /**
   Collect all the resource information under this root bridge.
 
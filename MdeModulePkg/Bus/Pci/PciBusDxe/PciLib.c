@@ -1017,6 +1017,10 @@ PciScanBus (
   PciAddress      = 0;
 
   for (Device = 0; Device <= PCI_MAX_DEVICE; Device++) {
+    if (Device == 1 && PciBridgeHasSingleDevice (Bridge)) {
+      break;
+    }
+
     TempReservedBusNum = 0;
     for (Func = 0; Func <= PCI_MAX_FUNC; Func++) {
 
@@ -50,6 +50,11 @@ typedef struct _USB_DEV_CONTEXT      USB_DEV_CONTEXT;
 //
 #define XHC_GENERIC_TIMEOUT          (10 * 1000)
 //
+// Max interval to poll the result of a synchronous transfer.
+// The unit is microsecond, setting it as 32us.
+//
+#define XHC_MAX_POLL_INTERVAL        (32 * XHC_1_MICROSECOND)
+//
 // XHC reset timeout experience values.
 // The unit is millisecond, setting it as 1s.
 //
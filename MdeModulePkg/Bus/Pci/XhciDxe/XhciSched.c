@@ -1272,8 +1272,9 @@ XhcExecTransfer (
   )
 {
   EFI_STATUS              Status;
-  UINTN                   Index;
+  UINT64                  Elapsed;
   UINT64                  Loop;
+  UINTN                   Interval;
   UINT8                   SlotId;
   UINT8                   Dci;
   BOOLEAN                 Finished;
@@ -1298,15 +1299,25 @@ XhcExecTransfer (
 
   XhcRingDoorBell (Xhc, SlotId, Dci);
 
-  for (Index = 0; Index < Loop; Index++) {
+  //
+  // Short transfers complete within a few microseconds, so poll at 1us first.
+  // Double the interval while the transfer is still running, to avoid walking
+  // the event ring and reading the runtime registers every microsecond during
+  // a long bulk transfer.
+  //
+  Elapsed  = 0;
+  Interval = XHC_1_MICROSECOND;
+  while (TRUE) {
     Finished = XhcCheckUrbResult (Xhc, Urb);
-    if (Finished) {
+    if (Finished || (Elapsed >= Loop)) {
       break;
     }
-    gBS->Stall (XHC_1_MICROSECOND);
+    gBS->Stall (Interval);
+    Elapsed  += Interval;
+    Interval  = MIN (Interval * 2, XHC_MAX_POLL_INTERVAL);
   }
 
-  if (Index == Loop) {
+  if (!Finished) {
     Urb->Result = EFI_USB_ERR_TIMEOUT;
     Status      = EFI_TIMEOUT;
   } else if (Urb->Result != EFI_USB_NOERROR) {
@@ -653,6 +653,7 @@ UsbFindChild (
   @param  HubIf                 The HUB that has the device connected.
   @param  Port                  The port index of the hub (started with zero).
   @param  ResetIsNeeded         The boolean to control whether skip the reset of the port.
+  @param  PortIsStable          The boolean to control whether skip the wait for the port to be stable.
 
   @retval EFI_SUCCESS           The device is enumerated (added or removed).
   @retval EFI_OUT_OF_RESOURCES  Failed to allocate resource for the device.
@@ -663,7 +664,8 @@ EFI_STATUS
 UsbEnumerateNewDev (
   IN USB_INTERFACE        *HubIf,
   IN UINT8                Port,
-  IN BOOLEAN              ResetIsNeeded
+  IN BOOLEAN              ResetIsNeeded,
+  IN BOOLEAN              PortIsStable
   )
 {
   USB_BUS                 *Bus;
@@ -680,7 +682,9 @@ UsbEnumerateNewDev (
   HubApi  = HubIf->HubApi;
   Address = Bus->MaxDevices;
 
-  gBS->Stall (USB_WAIT_PORT_STABLE_STALL);
+  if (!PortIsStable) {
+    gBS->Stall (USB_WAIT_PORT_STABLE_STALL);
+  }
 
   //
   // Hub resets the device for at least 10 milliseconds.
@@ -874,8 +878,13 @@ ON_ERROR:
 /**
   Process the events on the port.
 
+  The port status is read by the caller. Reading it may clear the change
+  bits of the port, so it is read only once and passed in.
+
   @param  HubIf                 The HUB that has the device connected.
   @param  Port                  The port index of the hub (started with zero).
+  @param  PortState             The status of the port read from the hub.
+  @param  PortIsStable          The boolean to control whether skip the wait for the port to be stable.
 
   @retval EFI_SUCCESS           The device is enumerated (added or removed).
   @retval EFI_OUT_OF_RESOURCES  Failed to allocate resource for the device.
@@ -885,37 +894,29 @@ ON_ERROR:
 EFI_STATUS
 UsbEnumeratePort (
   IN USB_INTERFACE        *HubIf,
-  IN UINT8                Port
+  IN UINT8                Port,
+  IN EFI_USB_PORT_STATUS  *PortState,
+  IN BOOLEAN              PortIsStable
   )
 {
   USB_HUB_API             *HubApi;
   USB_DEVICE              *Child;
-  EFI_USB_PORT_STATUS     PortState;
   EFI_STATUS              Status;
 
   Child   = NULL;
   HubApi  = HubIf->HubApi;
-
-  //
-  // Host learns of the new device by polling the hub for port changes.
-  //
-  Status = HubApi->GetPortStatus (HubIf, Port, &PortState);
-
-  if (EFI_ERROR (Status)) {
-    DEBUG ((EFI_D_ERROR, "UsbEnumeratePort: failed to get state of port %d\n", Port));
-    return Status;
-  }
+  Status  = EFI_SUCCESS;
 
   //
   // Only handle connection/enable/overcurrent/reset change.
   // Usb super speed hub may report other changes, such as warm reset change. Ignore them.
   //
-  if ((PortState.PortChangeStatus & (USB_PORT_STAT_C_CONNECTION | USB_PORT_STAT_C_ENABLE | USB_PORT_STAT_C_OVERCURRENT | USB_PORT_STAT_C_RESET)) == 0) {
+  if ((PortState->PortChangeStatus & (USB_PORT_STAT_C_CONNECTION | USB_PORT_STAT_C_ENABLE | USB_PORT_STAT_C_OVERCURRENT | USB_PORT_STAT_C_RESET)) == 0) {
     return EFI_SUCCESS;
   }
 
   DEBUG (( EFI_D_INFO, "UsbEnumeratePort: port %d state - %02x, change - %02x on %p\n",
-              Port, PortState.PortStatus, PortState.PortChangeStatus, HubIf));
+              Port, PortState->PortStatus, PortState->PortChangeStatus, HubIf));
 
   //
   // This driver only process two kinds of events now: over current and
@@ -923,9 +924,9 @@ UsbEnumeratePort (
   // ENABLE/RESET is used to reset port. SUSPEND isn't supported.
   //
 
-  if (USB_BIT_IS_SET (PortState.PortChangeStatus, USB_PORT_STAT_C_OVERCURRENT)) {
+  if (USB_BIT_IS_SET (PortState->PortChangeStatus, USB_PORT_STAT_C_OVERCURRENT)) {
 
-    if (USB_BIT_IS_SET (PortState.PortStatus, USB_PORT_STAT_OVERCURRENT)) {
+    if (USB_BIT_IS_SET (PortState->PortStatus, USB_PORT_STAT_OVERCURRENT)) {
       //
       // Case1:
       //   Both OverCurrent and OverCurrentChange set, means over current occurs,
@@ -945,7 +946,7 @@ UsbEnumeratePort (
     DEBUG (( EFI_D_ERROR, "UsbEnumeratePort: 2.0 device Recovery Over Current\n", Port));
   }
 
-  if (USB_BIT_IS_SET (PortState.PortChangeStatus, USB_PORT_STAT_C_ENABLE)) {
+  if (USB_BIT_IS_SET (PortState->PortChangeStatus, USB_PORT_STAT_C_ENABLE)) {
     //
     // Case3:
     //   1.1 roothub port reg doesn't reflect over-current state, while its counterpart
@@ -955,7 +956,7 @@ UsbEnumeratePort (
     DEBUG (( EFI_D_ERROR, "UsbEnumeratePort: 1.1 device Recovery Over Current\n", Port));
   }
 
-  if (USB_BIT_IS_SET (PortState.PortChangeStatus, USB_PORT_STAT_C_CONNECTION)) {
+  if (USB_BIT_IS_SET (PortState->PortChangeStatus, USB_PORT_STAT_C_CONNECTION)) {
     //
     // Case4:
     //   Device connected or disconnected normally.
@@ -973,15 +974,15 @@ UsbEnumeratePort (
     UsbRemoveDevice (Child);
   }
 
-  if (USB_BIT_IS_SET (PortState.PortStatus, USB_PORT_STAT_CONNECTION)) {
+  if (USB_BIT_IS_SET (PortState->PortStatus, USB_PORT_STAT_CONNECTION)) {
     //
     // Now, new device connected, enumerate and configure the device
     //
     DEBUG (( EFI_D_INFO, "UsbEnumeratePort: new device connected at port %d\n", Port));
-    if (USB_BIT_IS_SET (PortState.PortChangeStatus, USB_PORT_STAT_C_RESET)) {
-      Status = UsbEnumerateNewDev (HubIf, Port, FALSE);
+    if (USB_BIT_IS_SET (PortState->PortChangeStatus, USB_PORT_STAT_C_RESET)) {
+      Status = UsbEnumerateNewDev (HubIf, Port, FALSE, PortIsStable);
     } else {
-      Status = UsbEnumerateNewDev (HubIf, Port, TRUE);
+      Status = UsbEnumerateNewDev (HubIf, Port, TRUE, PortIsStable);
     }
 
   } else {
@@ -993,6 +994,130 @@ UsbEnumeratePort (
 }
 
 
+/**
+  Check whether UsbEnumeratePort() will enumerate a new device on the port.
+
+  @param  PortState             The status of the port read from the hub.
+
+  @retval TRUE                  A new device is connected to the port.
+  @retval FALSE                 No new device is connected to the port.
+
+**/
+BOOLEAN
+UsbPortHasNewDevice (
+  IN EFI_USB_PORT_STATUS  *PortState
+  )
+{
+  if ((PortState->PortChangeStatus & (USB_PORT_STAT_C_CONNECTION | USB_PORT_STAT_C_ENABLE | USB_PORT_STAT_C_OVERCURRENT | USB_PORT_STAT_C_RESET)) == 0) {
+    return FALSE;
+  }
+
+  if (USB_BIT_IS_SET (PortState->PortChangeStatus, USB_PORT_STAT_C_OVERCURRENT) &&
+      USB_BIT_IS_SET (PortState->PortStatus, USB_PORT_STAT_OVERCURRENT)) {
+    return FALSE;
+  }
+
+  return USB_BIT_IS_SET (PortState->PortStatus, USB_PORT_STAT_CONNECTION);
+}
+
+
+/**
+  Enumerate the changed ports of the hub.
+
+  Every new device has to wait for its port to be stable before the port is
+  reset. The status of the ports is read first, so that a single wait covers
+  all the devices connected at the same time, rather than one wait per device.
+  Reading the status may clear the change bits of the port, so it is read only
+  once and the same status is used to enumerate the port. The port resets are
+  still done one at a time, as the reset devices respond to the default address.
+
+  @param  HubIf                 The HUB whose ports are enumerated.
+  @param  ChangeMap             The bitmap of the changed ports, bit 0 for the hub
+                                itself. NULL to enumerate all the ports.
+
+**/
+VOID
+UsbEnumerateChangedPorts (
+  IN USB_INTERFACE        *HubIf,
+  IN UINT8                *ChangeMap OPTIONAL
+  )
+{
+  EFI_USB_PORT_STATUS     *PortStates;
+  UINT8                   StatusMap[32];
+  UINT8                   StableMap[32];
+  UINT8                   Byte;
+  UINT8                   Bit;
+  UINT8                   Index;
+  BOOLEAN                 NewDevice;
+  EFI_STATUS              Status;
+
+  if (HubIf->NumOfPort == 0) {
+    return ;
+  }
+
+  //
+  // The port status is not read yet if the allocation fails, so the
+  // changes are still reported to the next enumeration.
+  //
+  PortStates = AllocatePool (HubIf->NumOfPort * sizeof (EFI_USB_PORT_STATUS));
+  if (PortStates == NULL) {
+    return ;
+  }
+
+  ZeroMem (StatusMap, sizeof (StatusMap));
+  ZeroMem (StableMap, sizeof (StableMap));
+  NewDevice = FALSE;
+
+  //
+  // Host learns of the new device by polling the hub for port changes.
+  // HUB starts its port index with 1.
+  //
+  Byte  = 0;
+  Bit   = 1;
+
+  for (Index = 0; Index < HubIf->NumOfPort; Index++) {
+    if ((ChangeMap == NULL) || USB_BIT_IS_SET (ChangeMap[Byte], USB_BIT (Bit))) {
+      Status = HubIf->HubApi->GetPortStatus (HubIf, Index, &PortStates[Index]);
+
+      if (EFI_ERROR (Status)) {
+        DEBUG ((EFI_D_ERROR, "UsbEnumeratePort: failed to get state of port %d\n", Index));
+      } else {
+        StatusMap[Byte] |= (UINT8) USB_BIT (Bit);
+
+        if (UsbPortHasNewDevice (&PortStates[Index])) {
+          StableMap[Byte] |= (UINT8) USB_BIT (Bit);
+          NewDevice        = TRUE;
+        }
+      }
+    }
+
+    USB_NEXT_BIT (Byte, Bit);
+  }
+
+  if (NewDevice) {
+    gBS->Stall (USB_WAIT_PORT_STABLE_STALL);
+  }
+
+  Byte  = 0;
+  Bit   = 1;
+
+  for (Index = 0; Index < HubIf->NumOfPort; Index++) {
+    if (USB_BIT_IS_SET (StatusMap[Byte], USB_BIT (Bit))) {
+      UsbEnumeratePort (
+        HubIf,
+        Index,
+        &PortStates[Index],
+        USB_BIT_IS_SET (StableMap[Byte], USB_BIT (Bit))
+        );
+    }
+
+    USB_NEXT_BIT (Byte, Bit);
+  }
+
+  FreePool (PortStates);
+}
+
+
 /**
   Enumerate all the changed hub ports.
 
@@ -1008,8 +1133,6 @@ UsbHubEnumeration (
   )
 {
   USB_INTERFACE           *HubIf;
-  UINT8                   Byte;
-  UINT8                   Bit;
   UINT8                   Index;
   USB_DEVICE              *Child;
 
@@ -1029,19 +1152,7 @@ UsbHubEnumeration (
     return ;
   }
 
-  //
-  // HUB starts its port index with 1.
-  //
-  Byte  = 0;
-  Bit   = 1;
-
-  for (Index = 0; Index < HubIf->NumOfPort; Index++) {
-    if (USB_BIT_IS_SET (HubIf->ChangeMap[Byte], USB_BIT (Bit))) {
-      UsbEnumeratePort (HubIf, Index);
-    }
-
-    USB_NEXT_BIT (Byte, Bit);
-  }
+  UsbEnumerateChangedPorts (HubIf, HubIf->ChangeMap);
 
   UsbHubAckHubStatus (HubIf->Device);
 
@@ -1077,7 +1188,7 @@ UsbRootHubEnumeration (
       DEBUG (( EFI_D_INFO, "UsbEnumeratePort: The device disconnect fails at port %d from root hub %p, try again\n", Index, RootHub));
       UsbRemoveDevice (Child);
     }
-
-    UsbEnumeratePort (RootHub, Index);
   }
+
+  UsbEnumerateChangedPorts (RootHub, NULL);
 }
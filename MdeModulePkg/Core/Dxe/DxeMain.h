@@ -47,6 +47,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/HiiPackageList.h>
 #include <Protocol/SmmBase2.h>
 #include <Protocol/PeCoffImageEmulator.h>
+#include <Protocol/PoolStatistics.h>
 #include <Guid/MemoryTypeInformation.h>
 #include <Guid/FirmwareFileSystem2.h>
 #include <Guid/FirmwareFileSystem3.h>
@@ -255,6 +256,15 @@ typedef struct {
   LIST_ENTRY             CodeSegmentList;
 } IMAGE_PROPERTIES_RECORD;
 
+//
+// A memory range and the CPU attributes to apply to it
+//
+typedef struct {
+  EFI_PHYSICAL_ADDRESS   BaseAddress;
+  UINT64                 Length;
+  UINT64                 Attributes;
+} GCD_MEMORY_RANGE_ATTRIBUTES;
+
 //
 // DXE Core Global Variables
 //
@@ -1138,6 +1148,17 @@ CoreGetHandleDatabaseKey (
   );
 
 
+/**
+  Reports the protocol database hash table usage and lookup statistics through
+  DEBUG output.
+
+**/
+VOID
+CoreDumpProtocolDatabaseStatistics (
+  VOID
+  );
+
+
 /**
   Go connect any handles that were created or modified while a image executed.
 
@@ -1851,6 +1872,30 @@ CoreSetMemorySpaceAttributes (
   );
 
 
+/**
+  Apply CPU memory attributes to a set of memory ranges with a single pass
+  over the GCD memory space map.
+
+  @param  Ranges                 Array of ranges sorted by ascending address
+                                 without overlap.
+  @param  RangeCount             Number of entries in Ranges.
+  @param  PreserveMask           Attribute bits to keep from the GCD map.
+
+  @retval EFI_SUCCESS            The attributes were applied to all ranges.
+  @retval EFI_NOT_FOUND          A range base is not described by the GCD map.
+  @retval EFI_NOT_AVAILABLE_YET  The CPU Arch Protocol is not available yet.
+  @return others                 Return value of the first failed
+                                 gCpu->SetMemoryAttributes().
+
+**/
+EFI_STATUS
+CoreSetMemoryRangeAttributes (
+  IN OUT GCD_MEMORY_RANGE_ATTRIBUTES  *Ranges,
+  IN     UINTN                        RangeCount,
+  IN     UINT64                       PreserveMask
+  );
+
+
 /**
   Modifies the capabilities for a memory region in the global coherency domain of the
   processor.
@@ -2732,6 +2777,15 @@ MemoryProfileInstallProtocol (
   VOID
   );
 
+/**
+  Install the Pool Statistics Protocol.
+
+**/
+VOID
+CoreInstallPoolStatisticsProtocol (
+  VOID
+  );
+
 /**
   Register image to memory profile.
 
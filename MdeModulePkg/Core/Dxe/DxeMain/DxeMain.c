@@ -422,6 +422,7 @@ DxeMain (
   ASSERT_EFI_ERROR (Status);
 
   MemoryProfileInstallProtocol ();
+  CoreInstallPoolStatisticsProtocol ();
 
   CoreInitializePropertiesTable ();
   CoreInitializeMemoryAttributesTable ();
@@ -760,6 +761,10 @@ CoreExitBootServices (
 
   gMemoryMapTerminated = TRUE;
 
+  DEBUG_CODE_BEGIN ();
+    CoreDumpProtocolDatabaseStatistics ();
+  DEBUG_CODE_END ();
+
   //
   // Notify other drivers that we are exiting boot services.
   //
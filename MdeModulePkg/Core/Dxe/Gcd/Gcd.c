@@ -50,6 +50,14 @@ EFI_LOCK           mGcdIoSpaceLock     = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIF
 LIST_ENTRY         mGcdMemorySpaceMap  = INITIALIZE_LIST_HEAD_VARIABLE (mGcdMemorySpaceMap);
 LIST_ENTRY         mGcdIoSpaceMap      = INITIALIZE_LIST_HEAD_VARIABLE (mGcdIoSpaceMap);
 
+//
+// The entry found by the last CoreSearchGcdMapEntry() on each map. Lookups
+// usually walk ascending addresses (image sections, memory map descriptors),
+// so the next search resumes from here instead of the head of the map.
+//
+LIST_ENTRY         *mGcdMemorySpaceMapHint = NULL;
+LIST_ENTRY         *mGcdIoSpaceMapHint     = NULL;
+
 EFI_GCD_MAP_ENTRY mGcdMemorySpaceMapEntryTemplate = {
   EFI_GCD_MAP_SIGNATURE,
   {
@@ -456,6 +464,28 @@ CoreInsertGcdMapEntry (
 }
 
 
+/**
+  Return the lookup hint that belongs to a GCD map.
+
+  @param  Map                    The GCD memory space map or GCD IO space map.
+
+  @return The address of the lookup hint of Map.
+
+**/
+LIST_ENTRY **
+CoreGetGcdMapHint (
+  IN LIST_ENTRY  *Map
+  )
+{
+  if (Map == &mGcdMemorySpaceMap) {
+    return &mGcdMemorySpaceMapHint;
+  }
+
+  ASSERT (Map == &mGcdIoSpaceMap);
+  return &mGcdIoSpaceMapHint;
+}
+
+
 /**
   Merge the Gcd region specified by Link and its adjacent entry.
 
@@ -478,6 +508,7 @@ CoreMergeGcdMapEntry (
   LIST_ENTRY         *AdjacentLink;
   EFI_GCD_MAP_ENTRY  *Entry;
   EFI_GCD_MAP_ENTRY  *AdjacentEntry;
+  LIST_ENTRY         **Hint;
 
   //
   // Get adjacent entry
@@ -522,6 +553,15 @@ CoreMergeGcdMapEntry (
   } else {
     Entry->BaseAddress = AdjacentEntry->BaseAddress;
   }
+
+  //
+  // The merged entry now covers the range of the freed one
+  //
+  Hint = CoreGetGcdMapHint (Map);
+  if (*Hint == AdjacentLink) {
+    *Hint = Link;
+  }
+
   RemoveEntryList (AdjacentLink);
   CoreFreePool (AdjacentEntry);
 
@@ -595,6 +635,7 @@ CoreSearchGcdMapEntry (
   )
 {
   LIST_ENTRY         *Link;
+  LIST_ENTRY         **Hint;
   EFI_GCD_MAP_ENTRY  *Entry;
 
   ASSERT (Length != 0);
@@ -602,11 +643,24 @@ CoreSearchGcdMapEntry (
   *StartLink = NULL;
   *EndLink   = NULL;
 
+  //
+  // The map is sorted by address, so the search may start from the hint
+  // whenever the hint entry does not begin above BaseAddress.
+  //
   Link = Map->ForwardLink;
+  Hint = CoreGetGcdMapHint (Map);
+  if (*Hint != NULL) {
+    Entry = CR (*Hint, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
+    if (Entry->BaseAddress <= BaseAddress) {
+      Link = *Hint;
+    }
+  }
+
   while (Link != Map) {
     Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
     if (BaseAddress >= Entry->BaseAddress && BaseAddress <= Entry->EndAddress) {
       *StartLink = Link;
+      *Hint      = Link;
     }
     if (*StartLink != NULL) {
       if ((BaseAddress + Length - 1) >= Entry->BaseAddress &&
@@ -1627,6 +1681,119 @@ CoreSetMemorySpaceAttributes (
 }
 
 
+/**
+  Apply CPU memory attributes to a set of memory ranges with a single pass
+  over the GCD memory space map.
+
+  For each range, the bits in PreserveMask are taken from the GCD descriptor
+  that contains the range base, and all other bits from the range itself. The
+  resolved attributes are written back to Ranges. Adjacent ranges that resolve
+  to the same attributes are handed to the CPU Arch Protocol as one request.
+  A failed request does not stop the remaining ones. The GCD memory space map
+  itself is not modified.
+
+  @param  Ranges                 Array of ranges sorted by ascending address
+                                 without overlap.
+  @param  RangeCount             Number of entries in Ranges.
+  @param  PreserveMask           Attribute bits to keep from the GCD map.
+
+  @retval EFI_SUCCESS            The attributes were applied to all ranges.
+  @retval EFI_NOT_FOUND          A range base is not described by the GCD map.
+  @retval EFI_NOT_AVAILABLE_YET  The CPU Arch Protocol is not available yet.
+  @return others                 Return value of the first failed
+                                 gCpu->SetMemoryAttributes().
+
+**/
+EFI_STATUS
+CoreSetMemoryRangeAttributes (
+  IN OUT GCD_MEMORY_RANGE_ATTRIBUTES  *Ranges,
+  IN     UINTN                        RangeCount,
+  IN     UINT64                       PreserveMask
+  )
+{
+  EFI_STATUS            Status;
+  EFI_STATUS            CpuStatus;
+  LIST_ENTRY            *Link;
+  EFI_GCD_MAP_ENTRY     *Entry;
+  UINTN                 Index;
+  EFI_PHYSICAL_ADDRESS  BaseAddress;
+  UINT64                Length;
+  UINT64                Attributes;
+
+  if (RangeCount == 0) {
+    return EFI_SUCCESS;
+  }
+  if (gCpu == NULL) {
+    return EFI_NOT_AVAILABLE_YET;
+  }
+
+  //
+  // Resolve the attributes of all ranges under one lock acquisition. Since
+  // the ranges are sorted, the map is walked forward only once.
+  //
+  Status = EFI_SUCCESS;
+  CoreAcquireGcdMemoryLock ();
+  Link = mGcdMemorySpaceMap.ForwardLink;
+  for (Index = 0; Index < RangeCount; Index++) {
+    ASSERT (Ranges[Index].Length != 0);
+    ASSERT (Index == 0 ||
+            Ranges[Index].BaseAddress >= Ranges[Index - 1].BaseAddress + Ranges[Index - 1].Length);
+
+    while (Link != &mGcdMemorySpaceMap) {
+      Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
+      if (Ranges[Index].BaseAddress <= Entry->EndAddress) {
+        break;
+      }
+      Link = Link->ForwardLink;
+    }
+    if (Link == &mGcdMemorySpaceMap) {
+      Status = EFI_NOT_FOUND;
+      break;
+    }
+
+    Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
+    ASSERT (Ranges[Index].BaseAddress >= Entry->BaseAddress);
+    Ranges[Index].Attributes = (Entry->Attributes & PreserveMask) |
+                               (Ranges[Index].Attributes & ~PreserveMask);
+  }
+  CoreReleaseGcdMemoryLock ();
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Coalesce contiguous ranges with identical attributes into one call
+  //
+  BaseAddress = Ranges[0].BaseAddress;
+  Length      = Ranges[0].Length;
+  Attributes  = Ranges[0].Attributes;
+  for (Index = 1; Index <= RangeCount; Index++) {
+    if (Index < RangeCount &&
+        Ranges[Index].BaseAddress == BaseAddress + Length &&
+        Ranges[Index].Attributes == Attributes) {
+      Length += Ranges[Index].Length;
+      continue;
+    }
+
+    DEBUG ((DEBUG_GCD, "GCD:SetMemoryRangeAttributes(Base=%016lx,Length=%016lx)\n", BaseAddress, Length));
+    DEBUG ((DEBUG_GCD, "  Attributes  = %016lx\n", Attributes));
+    CpuStatus = gCpu->SetMemoryAttributes (gCpu, BaseAddress, Length, Attributes);
+    if (EFI_ERROR (CpuStatus) && !EFI_ERROR (Status)) {
+      Status = CpuStatus;
+    }
+
+    if (Index < RangeCount) {
+      BaseAddress = Ranges[Index].BaseAddress;
+      Length      = Ranges[Index].Length;
+      Attributes  = Ranges[Index].Attributes;
+    }
+  }
+
+  return Status;
+}
+
+
 /**
   Modifies the capabilities for a memory region in the global coherency domain of the
   processor.
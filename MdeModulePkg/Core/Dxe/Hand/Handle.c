@@ -11,16 +11,26 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 
 //
-// mProtocolDatabase     - A list of all protocols in the system.  (simple list for now)
+// mProtocolDatabase     - A list of all protocols in the system, in creation order
+// mProtocolHashTable    - The same protocols, hashed by GUID for lookup
 // gHandleList           - A list of all the handles in the system
 // gProtocolDatabaseLock - Lock to protect the mProtocolDatabase
 // gHandleDatabaseKey    -  The Key to show that the handle has been created/modified
 //
 LIST_ENTRY      mProtocolDatabase     = INITIALIZE_LIST_HEAD_VARIABLE (mProtocolDatabase);
+LIST_ENTRY      mProtocolHashTable[PROTOCOL_HASH_TABLE_SIZE];
+BOOLEAN         mProtocolHashTableInitialized = FALSE;
 LIST_ENTRY      gHandleList           = INITIALIZE_LIST_HEAD_VARIABLE (gHandleList);
 EFI_LOCK        gProtocolDatabaseLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
 UINT64          gHandleDatabaseKey    = 0;
 
+//
+// Protocol entry lookup statistics, only counted when DEBUG code is enabled
+//
+UINT64          mProtocolEntryLookups = 0;
+UINT64          mProtocolEntryHits    = 0;
+UINT64          mProtocolEntryProbes  = 0;
+
 
 
 /**
@@ -84,6 +94,41 @@ CoreValidateHandle (
 
 
 
+/**
+  Returns the mProtocolHashTable bucket for a protocol GUID.
+
+  @param  Protocol               The ID of the protocol
+
+  @return The list head of the bucket that holds Protocol
+
+**/
+STATIC
+LIST_ENTRY *
+CoreGetProtocolHashBucket (
+  IN EFI_GUID   *Protocol
+  )
+{
+  UINT32              Hash;
+  UINTN               Index;
+
+  if (!mProtocolHashTableInitialized) {
+    for (Index = 0; Index < PROTOCOL_HASH_TABLE_SIZE; Index++) {
+      InitializeListHead (&mProtocolHashTable[Index]);
+    }
+    mProtocolHashTableInitialized = TRUE;
+  }
+
+  Hash = ReadUnaligned32 ((UINT32 *)Protocol) ^
+         ReadUnaligned32 ((UINT32 *)Protocol + 1) ^
+         ReadUnaligned32 ((UINT32 *)Protocol + 2) ^
+         ReadUnaligned32 ((UINT32 *)Protocol + 3);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+
+  return &mProtocolHashTable[Hash & (PROTOCOL_HASH_TABLE_SIZE - 1)];
+}
+
+
 /**
   Finds the protocol entry for the requested protocol.
   The gProtocolDatabaseLock must be owned
@@ -100,6 +145,7 @@ CoreFindProtocolEntry (
   IN BOOLEAN    Create
   )
 {
+  LIST_ENTRY          *Bucket;
   LIST_ENTRY          *Link;
   PROTOCOL_ENTRY      *Item;
   PROTOCOL_ENTRY      *ProtEntry;
@@ -107,15 +153,24 @@ CoreFindProtocolEntry (
   ASSERT_LOCKED(&gProtocolDatabaseLock);
 
   //
-  // Search the database for the matching GUID
+  // Search the hash bucket for the matching GUID
   //
 
+  DEBUG_CODE_BEGIN ();
+    mProtocolEntryLookups++;
+  DEBUG_CODE_END ();
+
+  Bucket    = CoreGetProtocolHashBucket (Protocol);
   ProtEntry = NULL;
-  for (Link = mProtocolDatabase.ForwardLink;
-       Link != &mProtocolDatabase;
+  for (Link = Bucket->ForwardLink;
+       Link != Bucket;
        Link = Link->ForwardLink) {
 
-    Item = CR(Link, PROTOCOL_ENTRY, AllEntries, PROTOCOL_ENTRY_SIGNATURE);
+    DEBUG_CODE_BEGIN ();
+      mProtocolEntryProbes++;
+    DEBUG_CODE_END ();
+
+    Item = CR(Link, PROTOCOL_ENTRY, HashLink, PROTOCOL_ENTRY_SIGNATURE);
     if (CompareGuid (&Item->ProtocolID, Protocol)) {
 
       //
@@ -127,6 +182,12 @@ CoreFindProtocolEntry (
     }
   }
 
+  DEBUG_CODE_BEGIN ();
+    if (ProtEntry != NULL) {
+      mProtocolEntryHits++;
+    }
+  DEBUG_CODE_END ();
+
   //
   // If the protocol entry was not found and Create is TRUE, then
   // allocate a new entry
@@ -147,6 +208,7 @@ CoreFindProtocolEntry (
       // Add it to protocol database
       //
       InsertTailList (&mProtocolDatabase, &ProtEntry->AllEntries);
+      InsertTailList (Bucket, &ProtEntry->HashLink);
     }
   }
 
@@ -154,6 +216,64 @@ CoreFindProtocolEntry (
 }
 
 
+/**
+  Reports the protocol database hash table usage and lookup statistics through
+  DEBUG output.
+
+**/
+VOID
+CoreDumpProtocolDatabaseStatistics (
+  VOID
+  )
+{
+  UINTN               Entries;
+  UINTN               UsedBuckets;
+  UINTN               BucketEntries;
+  UINTN               MaxBucketEntries;
+  UINTN               Index;
+  LIST_ENTRY          *Link;
+
+  if (!mProtocolHashTableInitialized) {
+    return;
+  }
+
+  Entries          = 0;
+  UsedBuckets      = 0;
+  MaxBucketEntries = 0;
+  for (Index = 0; Index < PROTOCOL_HASH_TABLE_SIZE; Index++) {
+    BucketEntries = 0;
+    for (Link = mProtocolHashTable[Index].ForwardLink;
+         Link != &mProtocolHashTable[Index];
+         Link = Link->ForwardLink) {
+      BucketEntries++;
+    }
+    if (BucketEntries != 0) {
+      UsedBuckets++;
+    }
+    if (BucketEntries > MaxBucketEntries) {
+      MaxBucketEntries = BucketEntries;
+    }
+    Entries += BucketEntries;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "Protocol database: %Lu entries in %Lu of %d buckets, longest chain %Lu\n",
+    (UINT64) Entries,
+    (UINT64) UsedBuckets,
+    PROTOCOL_HASH_TABLE_SIZE,
+    (UINT64) MaxBucketEntries
+    ));
+  DEBUG ((
+    DEBUG_INFO,
+    "Protocol database: %Lu lookups, %Lu hits, %Lu probes\n",
+    mProtocolEntryLookups,
+    mProtocolEntryHits,
+    mProtocolEntryProbes
+    ));
+}
+
+
 
 /**
   Finds the protocol instance for the requested handle and protocol.
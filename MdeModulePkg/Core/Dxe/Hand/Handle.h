@@ -30,6 +30,11 @@ typedef struct {
 
 #define PROTOCOL_ENTRY_SIGNATURE        SIGNATURE_32('p','r','t','e')
 
+///
+/// Number of buckets in the protocol GUID hash table. Must be a power of 2.
+///
+#define PROTOCOL_HASH_TABLE_SIZE        128
+
 ///
 /// PROTOCOL_ENTRY - each different protocol has 1 entry in the protocol
 /// database.  Each handler that supports this protocol is listed, along
@@ -39,6 +44,8 @@ typedef struct {
   UINTN               Signature;
   /// Link Entry inserted to mProtocolDatabase
   LIST_ENTRY          AllEntries;
+  /// Link Entry inserted to the mProtocolHashTable bucket selected by ProtocolID
+  LIST_ENTRY          HashLink;
   /// ID of the protocol
   EFI_GUID            ProtocolID;
   /// All protocol interfaces
@@ -44,6 +44,12 @@ UINTN         mFreeMapStack = 0;
 ///
 LIST_ENTRY   mFreeMemoryMapEntryList = INITIALIZE_LIST_HEAD_VARIABLE (mFreeMemoryMapEntryList);
 BOOLEAN      mMemoryTypeInformationInitialized = FALSE;
+///
+/// mMemoryMapLookupHint - the memory map entry most recently selected or found
+/// by address, checked first by CoreFindMemoryMapEntry(). NULL if that entry
+/// has been removed from the memory map.
+///
+MEMORY_MAP   *mMemoryMapLookupHint = NULL;
 
 EFI_MEMORY_TYPE_STATISTICS mMemoryTypeStatistics[EfiMaxMemoryType + 1] = {
   { 0, MAX_ALLOC_ADDRESS, 0, 0, EfiMaxMemoryType, TRUE,  FALSE },  // EfiReservedMemoryType
@@ -135,6 +141,10 @@ RemoveMemoryMapEntry (
   RemoveEntryList (&Entry->Link);
   Entry->Link.ForwardLink = NULL;
 
+  if (Entry == mMemoryMapLookupHint) {
+    mMemoryMapLookupHint = NULL;
+  }
+
   if (Entry->FromPages) {
     //
     // Insert the free memory map descriptor to the end of mFreeMemoryMapEntryList
@@ -362,6 +372,10 @@ CoreFreeMemoryMapStack (
       CopyMem (Entry , &mMapStack[mMapDepth], sizeof (MEMORY_MAP));
       Entry->FromPages = TRUE;
 
+      if (mMemoryMapLookupHint == &mMapStack[mMapDepth]) {
+        mMemoryMapLookupHint = Entry;
+      }
+
       //
       // Find insertion location
       //
@@ -386,6 +400,44 @@ CoreFreeMemoryMapStack (
   mFreeMapStack -= 1;
 }
 
+/**
+  Internal function.  Finds the memory map entry that covers an address.
+
+  The entry found is remembered, and checked first on the next call, so that
+  converting pages just selected by CoreFindFreePagesI(), or a run of
+  conversions within the same descriptor, does not walk the memory map.
+
+  @param  Address                The address to look up
+
+  @return The entry whose range covers Address, or NULL if there is none
+
+**/
+MEMORY_MAP *
+CoreFindMemoryMapEntry (
+  IN EFI_PHYSICAL_ADDRESS  Address
+  )
+{
+  LIST_ENTRY      *Link;
+  MEMORY_MAP      *Entry;
+
+  ASSERT_LOCKED (&gMemoryLock);
+
+  Entry = mMemoryMapLookupHint;
+  if (Entry != NULL && Entry->Start <= Address && Entry->End > Address) {
+    return Entry;
+  }
+
+  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
+    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
+    if (Entry->Start <= Address && Entry->End > Address) {
+      mMemoryMapLookupHint = Entry;
+      return Entry;
+    }
+  }
+
+  return NULL;
+}
+
 /**
   Find untested but initialized memory regions in GCD map and convert them to be DXE allocatable.
 
@@ -736,7 +788,6 @@ CoreConvertPagesEx (
   UINT64          RangeEnd;
   UINT64          Attribute;
   EFI_MEMORY_TYPE MemType;
-  LIST_ENTRY      *Link;
   MEMORY_MAP      *Entry;
 
   Entry = NULL;
@@ -762,15 +813,8 @@ CoreConvertPagesEx (
     //
     // Find the entry that the covers the range
     //
-    for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-      Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-
-      if (Entry->Start <= Start && Entry->End > Start) {
-        break;
-      }
-    }
-
-    if (Link == &gMemoryMap) {
+    Entry = CoreFindMemoryMapEntry (Start);
+    if (Entry == NULL) {
       DEBUG ((DEBUG_ERROR | DEBUG_PAGE, "ConvertPages: failed to find range %lx - %lx\n", Start, End));
       return EFI_NOT_FOUND;
     }
@@ -1040,6 +1084,7 @@ CoreFindFreePagesI (
   UINT64          DescNumberOfBytes;
   LIST_ENTRY      *Link;
   MEMORY_MAP      *Entry;
+  MEMORY_MAP      *TargetEntry;
 
   if ((MaxAddress < EFI_PAGE_MASK) ||(NumberOfPages == 0)) {
     return 0;
@@ -1069,6 +1114,7 @@ CoreFindFreePagesI (
 
   NumberOfBytes = LShiftU64 (NumberOfPages, EFI_PAGE_SHIFT);
   Target = 0;
+  TargetEntry = NULL;
 
   for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
     Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
@@ -1134,6 +1180,7 @@ CoreFindFreePagesI (
         }
 
         Target = DescEnd;
+        TargetEntry = Entry;
       }
     }
   }
@@ -1150,6 +1197,11 @@ CoreFindFreePagesI (
     return 0;
   }
 
+  //
+  // The caller is about to convert the range just found
+  //
+  mMemoryMapLookupHint = TargetEntry;
+
   return Target;
 }
 
@@ -1477,7 +1529,6 @@ CoreInternalFreePages (
   )
 {
   EFI_STATUS      Status;
-  LIST_ENTRY      *Link;
   MEMORY_MAP      *Entry;
   UINTN           Alignment;
   BOOLEAN         IsGuarded;
@@ -1491,14 +1542,8 @@ CoreInternalFreePages (
   // Find the entry that the covers the range
   //
   IsGuarded = FALSE;
-  Entry = NULL;
-  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-    Entry = CR(Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-    if (Entry->Start <= Memory && Entry->End > Memory) {
-        break;
-    }
-  }
-  if (Link == &gMemoryMap) {
+  Entry = CoreFindMemoryMapEntry (Memory);
+  if (Entry == NULL) {
     Status = EFI_NOT_FOUND;
     goto Done;
   }
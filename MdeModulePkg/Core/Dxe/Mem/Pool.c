@@ -41,6 +41,24 @@ typedef struct {
 
 #define POOL_OVERHEAD (SIZE_OF_POOL_HEAD + sizeof(POOL_TAIL))
 
+//
+// When PcdDxePoolSlabAllocator is TRUE, each pool page chunk backing a size
+// class holds blocks of that class only, and starts with a slab header. Blocks
+// that have never been allocated lie past Offset, freed blocks are kept on
+// FreeList.
+//
+#define POOL_SLAB_SIGNATURE   SIGNATURE_32('p','s','l','b')
+typedef struct {
+  UINT32          Signature;
+  UINT32          Index;
+  UINTN           LiveBlocks;
+  UINTN           Offset;
+  LIST_ENTRY      FreeList;
+  LIST_ENTRY      Link;
+} POOL_SLAB;
+
+#define SIZE_OF_POOL_SLAB ALIGN_VALUE (sizeof (POOL_SLAB), 16)
+
 #define HEAD_TO_TAIL(a)   \
   ((POOL_TAIL *) (((CHAR8 *) (a)) + (a)->Size - sizeof(POOL_TAIL)));
 
@@ -70,7 +88,20 @@ typedef struct {
     UINTN            Used;
     EFI_MEMORY_TYPE  MemoryType;
     LIST_ENTRY       FreeList[MAX_POOL_LIST];
+    //
+    // Slabs of each size class that still have a block to allocate
+    //
+    LIST_ENTRY       SlabList[MAX_POOL_LIST];
     LIST_ENTRY       Link;
+    //
+    // Usage of each size class. The extra last entry accounts for the
+    // allocations served directly from pages.
+    //
+    EDKII_POOL_CLASS_STATISTICS  Stats[MAX_POOL_LIST + 1];
+    //
+    // Pages currently carved up to serve the size classes
+    //
+    UINTN            Pages;
 } POOL;
 
 //
@@ -83,6 +114,21 @@ POOL            mPoolHead[EfiMaxMemoryType];
 //
 LIST_ENTRY      mPoolHeadList = INITIALIZE_LIST_HEAD_VARIABLE (mPoolHeadList);
 
+EFI_STATUS
+EFIAPI
+PoolStatisticsGetStatistics (
+  IN     EDKII_POOL_STATISTICS_PROTOCOL   *This,
+  IN     EFI_MEMORY_TYPE                  MemoryType,
+  IN OUT UINTN                            *ClassCount,
+  OUT    EDKII_POOL_CLASS_STATISTICS      *ClassStatistics,
+  OUT    UINT64                           *PoolPages OPTIONAL
+  );
+
+STATIC EDKII_POOL_STATISTICS_PROTOCOL mPoolStatisticsProtocol = {
+  EDKII_POOL_STATISTICS_PROTOCOL_REVISION,
+  PoolStatisticsGetStatistics
+};
+
 /**
   Get pool size table index from the specified size.
 
@@ -107,6 +153,69 @@ GetPoolIndexFromSize (
   return MAX_POOL_LIST;
 }
 
+/**
+  Get the granularity of the pages backing the pool of a memory type.
+
+  @param  MemoryType    The memory type of the pool.
+
+  @return               The page allocation granularity of MemoryType.
+
+**/
+STATIC
+UINTN
+GetPoolGranularity (
+  IN EFI_MEMORY_TYPE  MemoryType
+  )
+{
+  if  (MemoryType == EfiACPIReclaimMemory   ||
+       MemoryType == EfiACPIMemoryNVS       ||
+       MemoryType == EfiRuntimeServicesCode ||
+       MemoryType == EfiRuntimeServicesData) {
+
+    return RUNTIME_PAGE_ALLOCATION_GRANULARITY;
+  }
+  return DEFAULT_PAGE_ALLOCATION_GRANULARITY;
+}
+
+/**
+  Account for a pool block being allocated or freed.
+
+  @param  Pool                   The pool head of the memory type of the block
+  @param  ClassIndex             The size class of the block, or MAX_POOL_LIST
+                                 if it is served directly from pages
+  @param  BlockSize              The number of bytes taken by the block
+  @param  Payload                The number of bytes of the block usable by the caller
+  @param  Allocate               TRUE if the block is allocated, FALSE if it is freed
+
+**/
+STATIC
+VOID
+UpdatePoolStatistics (
+  IN POOL     *Pool,
+  IN UINTN    ClassIndex,
+  IN UINTN    BlockSize,
+  IN UINTN    Payload,
+  IN BOOLEAN  Allocate
+  )
+{
+  EDKII_POOL_CLASS_STATISTICS   *Stats;
+
+  ASSERT (ClassIndex <= MAX_POOL_LIST);
+  ASSERT (BlockSize >= Payload);
+
+  Stats = &Pool->Stats[ClassIndex];
+  if (Allocate) {
+    Stats->LiveBlocks++;
+    Stats->LiveBytes   += Payload;
+    Stats->WastedBytes += BlockSize - Payload;
+    Stats->TotalAllocations++;
+  } else {
+    Stats->LiveBlocks--;
+    Stats->LiveBytes   -= Payload;
+    Stats->WastedBytes -= BlockSize - Payload;
+  }
+}
+
 /**
   Called to initialize the pool.
 
@@ -123,9 +232,12 @@ CoreInitializePool (
     mPoolHead[Type].Signature  = 0;
     mPoolHead[Type].Used       = 0;
     mPoolHead[Type].MemoryType = (EFI_MEMORY_TYPE) Type;
+    mPoolHead[Type].Pages      = 0;
     for (Index=0; Index < MAX_POOL_LIST; Index++) {
       InitializeListHead (&mPoolHead[Type].FreeList[Index]);
+      InitializeListHead (&mPoolHead[Type].SlabList[Index]);
     }
+    ZeroMem (mPoolHead[Type].Stats, sizeof (mPoolHead[Type].Stats));
   }
 }
 
@@ -173,9 +285,12 @@ LookupPoolHead (
     Pool->Signature = POOL_SIGNATURE;
     Pool->Used      = 0;
     Pool->MemoryType = MemoryType;
+    Pool->Pages     = 0;
     for (Index=0; Index < MAX_POOL_LIST; Index++) {
       InitializeListHead (&Pool->FreeList[Index]);
+      InitializeListHead (&Pool->SlabList[Index]);
     }
+    ZeroMem (Pool->Stats, sizeof (Pool->Stats));
 
     InsertHeadList (&mPoolHeadList, &Pool->Link);
 
@@ -332,6 +447,96 @@ CoreAllocatePoolPagesI (
   return Buffer;
 }
 
+/**
+  Check whether a slab has no block left to allocate.
+
+  @param  Slab                   The slab to check
+  @param  Granularity            The size of the slab
+
+  @retval TRUE                   All the blocks of the slab are allocated.
+  @retval FALSE                  The slab has a block to allocate.
+
+**/
+STATIC
+BOOLEAN
+IsPoolSlabFull (
+  IN POOL_SLAB  *Slab,
+  IN UINTN      Granularity
+  )
+{
+  return (BOOLEAN) (IsListEmpty (&Slab->FreeList) &&
+                    Slab->Offset + LIST_TO_SIZE (Slab->Index) > Granularity);
+}
+
+/**
+  Internal function to allocate a block of a size class from the slabs of a
+  pool. Caller must have the memory lock held
+
+  @param  Pool                   The pool head of the memory type to allocate
+  @param  Index                  The size class of the block
+  @param  Granularity            The size of each slab
+
+  @return The allocated block, or NULL
+
+**/
+STATIC
+POOL_HEAD *
+CoreAllocatePoolSlabI (
+  IN POOL   *Pool,
+  IN UINTN  Index,
+  IN UINTN  Granularity
+  )
+{
+  POOL_SLAB   *Slab;
+  POOL_FREE   *Free;
+  POOL_HEAD   *Head;
+
+  ASSERT (SIZE_OF_POOL_SLAB + LIST_TO_SIZE (Index) <= Granularity);
+
+  //
+  // If no slab of this size class has a block left, go get another page
+  //
+  if (IsListEmpty (&Pool->SlabList[Index])) {
+    Slab = CoreAllocatePoolPagesI (Pool->MemoryType, EFI_SIZE_TO_PAGES (Granularity),
+                                   Granularity, FALSE);
+    if (Slab == NULL) {
+      return NULL;
+    }
+    Pool->Pages += EFI_SIZE_TO_PAGES (Granularity);
+
+    Slab->Signature  = POOL_SLAB_SIGNATURE;
+    Slab->Index      = (UINT32)Index;
+    Slab->LiveBlocks = 0;
+    Slab->Offset     = SIZE_OF_POOL_SLAB;
+    InitializeListHead (&Slab->FreeList);
+    InsertHeadList (&Pool->SlabList[Index], &Slab->Link);
+  }
+
+  Slab = CR (Pool->SlabList[Index].ForwardLink, POOL_SLAB, Link, POOL_SLAB_SIGNATURE);
+
+  //
+  // Reuse a freed block first, then take the next block never allocated
+  //
+  if (!IsListEmpty (&Slab->FreeList)) {
+    Free = CR (Slab->FreeList.ForwardLink, POOL_FREE, Link, POOL_FREE_SIGNATURE);
+    RemoveEntryList (&Free->Link);
+    Head = (POOL_HEAD *) Free;
+  } else {
+    Head = (POOL_HEAD *) ((CHAR8 *) Slab + Slab->Offset);
+    Slab->Offset += LIST_TO_SIZE (Index);
+  }
+  Slab->LiveBlocks++;
+
+  //
+  // A full slab leaves the list until one of its blocks is freed
+  //
+  if (IsPoolSlabFull (Slab, Granularity)) {
+    RemoveEntryList (&Slab->Link);
+  }
+
+  return Head;
+}
+
 /**
   Internal function to allocate pool of a particular type.
   Caller must have the memory lock held
@@ -357,6 +562,8 @@ CoreAllocatePoolI (
   CHAR8       *NewPage;
   VOID        *Buffer;
   UINTN       Index;
+  UINTN       ClassIndex;
+  UINTN       BlockSize;
   UINTN       FSize;
   UINTN       Offset, MaxOffset;
   UINTN       NoPages;
@@ -366,15 +573,7 @@ CoreAllocatePoolI (
 
   ASSERT_LOCKED (&mPoolMemoryLock);
 
-  if  (PoolType == EfiACPIReclaimMemory   ||
-       PoolType == EfiACPIMemoryNVS       ||
-       PoolType == EfiRuntimeServicesCode ||
-       PoolType == EfiRuntimeServicesData) {
-
-    Granularity = RUNTIME_PAGE_ALLOCATION_GRANULARITY;
-  } else {
-    Granularity = DEFAULT_PAGE_ALLOCATION_GRANULARITY;
-  }
+  Granularity = GetPoolGranularity (PoolType);
 
   //
   // Adjust the size by the pool header & tail overhead
@@ -409,6 +608,8 @@ CoreAllocatePoolI (
     }
     NoPages = EFI_SIZE_TO_PAGES (Size) + EFI_SIZE_TO_PAGES (Granularity) - 1;
     NoPages &= ~(UINTN)(EFI_SIZE_TO_PAGES (Granularity) - 1);
+    ClassIndex = MAX_POOL_LIST;
+    BlockSize  = EFI_PAGES_TO_SIZE (NoPages);
     Head = CoreAllocatePoolPagesI (PoolType, NoPages, Granularity, NeedGuard);
     if (NeedGuard) {
       Head = AdjustPoolHeadA ((EFI_PHYSICAL_ADDRESS)(UINTN)Head, NoPages, Size);
@@ -416,6 +617,14 @@ CoreAllocatePoolI (
     goto Done;
   }
 
+  ClassIndex = Index;
+  BlockSize  = LIST_TO_SIZE (Index);
+
+  if (FeaturePcdGet (PcdDxePoolSlabAllocator)) {
+    Head = CoreAllocatePoolSlabI (Pool, Index, Granularity);
+    goto Done;
+  }
+
   //
   // If there's no free pool in the proper list size, go get some more pages
   //
@@ -445,6 +654,7 @@ CoreAllocatePoolI (
     if (NewPage == NULL) {
       goto Done;
     }
+    Pool->Pages += EFI_SIZE_TO_PAGES (Granularity);
 
     //
     // Serve the allocation request from the head of the allocated block
@@ -510,6 +720,8 @@ Done:
       Size -= SIZE_OF_POOL_HEAD;
     }
 
+    UpdatePoolStatistics (Pool, ClassIndex, BlockSize, Size, TRUE);
+
     DEBUG_CLEAR_MEMORY (Buffer, Size);
 
     DEBUG ((
@@ -653,6 +865,62 @@ CoreFreePoolPagesWithGuard (
   }
 }
 
+/**
+  Internal function to free a block allocated by CoreAllocatePoolSlabI().
+  Caller must have the memory lock held
+
+  The slab of the block is found from the block address, so neither the free
+  block lists nor the slab pages are walked.
+
+  @param  Pool                   The pool head of the memory type of the block
+  @param  Head                   The block to free
+  @param  Index                  The size class of the block
+  @param  Granularity            The size of each slab
+
+**/
+STATIC
+VOID
+CoreFreePoolSlabI (
+  IN POOL       *Pool,
+  IN POOL_HEAD  *Head,
+  IN UINTN      Index,
+  IN UINTN      Granularity
+  )
+{
+  POOL_SLAB   *Slab;
+  POOL_FREE   *Free;
+  BOOLEAN     WasFull;
+
+  Slab = (POOL_SLAB *)((UINTN)Head & ~(Granularity - 1));
+  ASSERT (Slab->Signature == POOL_SLAB_SIGNATURE);
+  ASSERT (Slab->Index == Index);
+  ASSERT (Slab->LiveBlocks > 0);
+
+  WasFull = IsPoolSlabFull (Slab, Granularity);
+
+  Free = (POOL_FREE *) Head;
+  Free->Signature = POOL_FREE_SIGNATURE;
+  Free->Index     = (UINT32)Index;
+  InsertHeadList (&Slab->FreeList, &Free->Link);
+  Slab->LiveBlocks--;
+
+  if (Slab->LiveBlocks == 0) {
+    //
+    // The free blocks of the slab are only linked to the slab itself, so the
+    // page can be given back as is
+    //
+    if (!WasFull) {
+      RemoveEntryList (&Slab->Link);
+    }
+    Slab->Signature = 0;
+    Pool->Pages -= EFI_SIZE_TO_PAGES (Granularity);
+    CoreFreePoolPagesI (Pool->MemoryType, (EFI_PHYSICAL_ADDRESS) (UINTN)Slab,
+      EFI_SIZE_TO_PAGES (Granularity));
+  } else if (WasFull) {
+    InsertHeadList (&Pool->SlabList[Index], &Slab->Link);
+  }
+}
+
 /**
   Internal function to free a pool entry.
   Caller must have the memory lock held
@@ -677,6 +945,7 @@ CoreFreePoolI (
   UINTN       Index;
   UINTN       NoPages;
   UINTN       Size;
+  UINTN       Payload;
   CHAR8       *NewPage;
   UINTN       Offset;
   BOOLEAN     AllFree;
@@ -736,16 +1005,9 @@ CoreFreePoolI (
   }
   Pool->Used -= Size;
   DEBUG ((DEBUG_POOL, "FreePool: %p (len %lx) %,ld\n", Head->Data, (UINT64)(Head->Size - POOL_OVERHEAD), (UINT64) Pool->Used));
+  Payload = HasPoolTail ? Size - POOL_OVERHEAD : Size - SIZE_OF_POOL_HEAD;
 
-  if  (Head->Type == EfiACPIReclaimMemory   ||
-       Head->Type == EfiACPIMemoryNVS       ||
-       Head->Type == EfiRuntimeServicesCode ||
-       Head->Type == EfiRuntimeServicesData) {
-
-    Granularity = RUNTIME_PAGE_ALLOCATION_GRANULARITY;
-  } else {
-    Granularity = DEFAULT_PAGE_ALLOCATION_GRANULARITY;
-  }
+  Granularity = GetPoolGranularity (Head->Type);
 
   if (PoolType != NULL) {
     *PoolType = Head->Type;
@@ -767,6 +1029,7 @@ CoreFreePoolI (
     //
     NoPages = EFI_SIZE_TO_PAGES (Size) + EFI_SIZE_TO_PAGES (Granularity) - 1;
     NoPages &= ~(UINTN)(EFI_SIZE_TO_PAGES (Granularity) - 1);
+    UpdatePoolStatistics (Pool, MAX_POOL_LIST, EFI_PAGES_TO_SIZE (NoPages), Payload, FALSE);
     if (IsGuarded) {
       Head = AdjustPoolHeadF ((EFI_PHYSICAL_ADDRESS)(UINTN)Head);
       CoreFreePoolPagesWithGuard (
@@ -782,8 +1045,15 @@ CoreFreePoolI (
         );
     }
 
+  } else if (FeaturePcdGet (PcdDxePoolSlabAllocator)) {
+
+    UpdatePoolStatistics (Pool, Index, LIST_TO_SIZE (Index), Payload, FALSE);
+    CoreFreePoolSlabI (Pool, Head, Index, Granularity);
+
   } else {
 
+    UpdatePoolStatistics (Pool, Index, LIST_TO_SIZE (Index), Payload, FALSE);
+
     //
     // Put the pool entry onto the free pool list
     //
@@ -836,6 +1106,7 @@ CoreFreePoolI (
         //
         // Free the page
         //
+        Pool->Pages -= EFI_SIZE_TO_PAGES (Granularity);
         CoreFreePoolPagesI (Pool->MemoryType, (EFI_PHYSICAL_ADDRESS) (UINTN)NewPage,
           EFI_SIZE_TO_PAGES (Granularity));
       }
@@ -855,3 +1126,126 @@ CoreFreePoolI (
   return EFI_SUCCESS;
 }
 
+
+/**
+  Retrieve the pool usage of one memory type.
+
+  @param[in]      This              The EDKII_POOL_STATISTICS_PROTOCOL instance.
+  @param[in]      MemoryType        The memory type to report.
+  @param[in, out] ClassCount        On input, the number of entries in ClassStatistics.
+                                    On output, the number of pool size classes.
+  @param[out]     ClassStatistics   The usage of each pool size class. The last
+                                    entry describes allocations served directly
+                                    from pages.
+  @param[out]     PoolPages         The number of pages currently owned by the pool
+                                    allocator to serve allocations of MemoryType
+                                    from the size classes. Optional.
+
+  @retval EFI_SUCCESS               The statistics were returned.
+  @retval EFI_INVALID_PARAMETER     ClassCount is NULL.
+  @retval EFI_INVALID_PARAMETER     ClassStatistics is NULL and *ClassCount is not 0.
+  @retval EFI_NOT_FOUND             The pool allocator does not track MemoryType. It
+                                    is a reserved memory type, or an OEM or OS loader
+                                    memory type that has no pool yet.
+  @retval EFI_BUFFER_TOO_SMALL      *ClassCount is too small. It has been updated
+                                    with the number of classes.
+
+**/
+EFI_STATUS
+EFIAPI
+PoolStatisticsGetStatistics (
+  IN     EDKII_POOL_STATISTICS_PROTOCOL   *This,
+  IN     EFI_MEMORY_TYPE                  MemoryType,
+  IN OUT UINTN                            *ClassCount,
+  OUT    EDKII_POOL_CLASS_STATISTICS      *ClassStatistics,
+  OUT    UINT64                           *PoolPages OPTIONAL
+  )
+{
+  POOL        *Pool;
+  POOL_SLAB   *Slab;
+  LIST_ENTRY  *Link;
+  UINTN       Index;
+  UINTN       Granularity;
+
+  if ((ClassCount == NULL) || ((ClassStatistics == NULL) && (*ClassCount != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (*ClassCount < MAX_POOL_LIST + 1) {
+    *ClassCount = MAX_POOL_LIST + 1;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+  *ClassCount = MAX_POOL_LIST + 1;
+
+  CoreAcquireLock (&mPoolMemoryLock);
+
+  //
+  // Unlike LookupPoolHead(), never create a pool head for an OEM/OS type
+  //
+  Pool = NULL;
+  if ((UINT32)MemoryType < EfiMaxMemoryType) {
+    Pool = &mPoolHead[MemoryType];
+  } else if ((UINT32)MemoryType >= MEMORY_TYPE_OEM_RESERVED_MIN) {
+    for (Link = mPoolHeadList.ForwardLink; Link != &mPoolHeadList; Link = Link->ForwardLink) {
+      if (CR (Link, POOL, Link, POOL_SIGNATURE)->MemoryType == MemoryType) {
+        Pool = CR (Link, POOL, Link, POOL_SIGNATURE);
+        break;
+      }
+    }
+  }
+
+  if (Pool == NULL) {
+    CoreReleaseLock (&mPoolMemoryLock);
+    return EFI_NOT_FOUND;
+  }
+
+  Granularity = GetPoolGranularity (Pool->MemoryType);
+  CopyMem (ClassStatistics, Pool->Stats, sizeof (Pool->Stats));
+  for (Index = 0; Index < MAX_POOL_LIST; Index++) {
+    ClassStatistics[Index].BlockSize  = LIST_TO_SIZE (Index);
+    ClassStatistics[Index].FreeBlocks = 0;
+    for (Link = Pool->FreeList[Index].ForwardLink;
+         Link != &Pool->FreeList[Index];
+         Link = Link->ForwardLink) {
+      ClassStatistics[Index].FreeBlocks++;
+    }
+    for (Link = Pool->SlabList[Index].ForwardLink;
+         Link != &Pool->SlabList[Index];
+         Link = Link->ForwardLink) {
+      Slab = CR (Link, POOL_SLAB, Link, POOL_SLAB_SIGNATURE);
+      ClassStatistics[Index].FreeBlocks +=
+        (Granularity - SIZE_OF_POOL_SLAB) / LIST_TO_SIZE (Index) - Slab->LiveBlocks;
+    }
+  }
+  ClassStatistics[MAX_POOL_LIST].BlockSize  = 0;
+  ClassStatistics[MAX_POOL_LIST].FreeBlocks = 0;
+
+  if (PoolPages != NULL) {
+    *PoolPages = Pool->Pages;
+  }
+
+  CoreReleaseLock (&mPoolMemoryLock);
+  return EFI_SUCCESS;
+}
+
+/**
+  Install the Pool Statistics Protocol.
+
+**/
+VOID
+CoreInstallPoolStatisticsProtocol (
+  VOID
+  )
+{
+  EFI_HANDLE    Handle;
+  EFI_STATUS    Status;
+
+  Handle = NULL;
+  Status = CoreInstallMultipleProtocolInterfaces (
+             &Handle,
+             &gEdkiiPoolStatisticsProtocolGuid,
+             &mPoolStatisticsProtocol,
+             NULL
+             );
+  ASSERT_EFI_ERROR (Status);
+}
@@ -230,6 +230,36 @@ SetUefiImageMemoryAttributes (
   gCpu->SetMemoryAttributes (gCpu, BaseAddress, Length, FinalAttributes);
 }
 
+/**
+  Queue a UEFI image range for protection, or protect it immediately if no
+  range buffer is available.
+
+  @param[in, out]  Ranges         Range buffer, or NULL.
+  @param[in, out]  RangeCount     Number of ranges queued in Ranges.
+  @param[in]       BaseAddress    Specified start address
+  @param[in]       Length         Specified length
+  @param[in]       Attributes     Specified attributes
+**/
+VOID
+AddUefiImageMemoryRange (
+  IN OUT GCD_MEMORY_RANGE_ATTRIBUTES  *Ranges OPTIONAL,
+  IN OUT UINTN                        *RangeCount,
+  IN     UINT64                       BaseAddress,
+  IN     UINT64                       Length,
+  IN     UINT64                       Attributes
+  )
+{
+  if (Ranges == NULL) {
+    SetUefiImageMemoryAttributes (BaseAddress, Length, Attributes);
+    return;
+  }
+
+  Ranges[*RangeCount].BaseAddress = BaseAddress;
+  Ranges[*RangeCount].Length      = Length;
+  Ranges[*RangeCount].Attributes  = Attributes & MEMORY_ATTRIBUTE_MASK;
+  (*RangeCount)++;
+}
+
 /**
   Set UEFI image protection attributes.
 
@@ -246,6 +276,19 @@ SetUefiImageProtectionAttributes (
   LIST_ENTRY                                *ImageRecordCodeSectionList;
   UINT64                                    CurrentBase;
   UINT64                                    ImageEnd;
+  GCD_MEMORY_RANGE_ATTRIBUTES               *Ranges;
+  UINTN                                     RangeCount;
+  UINTN                                     Index;
+  EFI_STATUS                                Status;
+
+  //
+  // Every code section may be preceded by a data range, plus the trailing
+  // data range. Collect them all so the GCD map is walked once per image
+  // rather than once per section. Without a buffer, fall back to setting
+  // each range on its own.
+  //
+  Ranges = AllocatePool ((2 * ImageRecord->CodeSegmentCount + 1) * sizeof (GCD_MEMORY_RANGE_ATTRIBUTES));
+  RangeCount = 0;
 
   ImageRecordCodeSectionList = &ImageRecord->CodeSegmentList;
 
@@ -268,7 +311,9 @@ SetUefiImageProtectionAttributes (
       //
       // DATA
       //
-      SetUefiImageMemoryAttributes (
+      AddUefiImageMemoryRange (
+        Ranges,
+        &RangeCount,
         CurrentBase,
         ImageRecordCodeSection->CodeSegmentBase - CurrentBase,
         EFI_MEMORY_XP
@@ -277,7 +322,9 @@ SetUefiImageProtectionAttributes (
     //
     // CODE
     //
-    SetUefiImageMemoryAttributes (
+    AddUefiImageMemoryRange (
+      Ranges,
+      &RangeCount,
       ImageRecordCodeSection->CodeSegmentBase,
       ImageRecordCodeSection->CodeSegmentSize,
       EFI_MEMORY_RO
@@ -292,12 +339,36 @@ SetUefiImageProtectionAttributes (
     //
     // DATA
     //
-    SetUefiImageMemoryAttributes (
+    AddUefiImageMemoryRange (
+      Ranges,
+      &RangeCount,
       CurrentBase,
       ImageEnd - CurrentBase,
       EFI_MEMORY_XP
       );
   }
+
+  if (Ranges != NULL) {
+    ASSERT (RangeCount <= 2 * ImageRecord->CodeSegmentCount + 1);
+    ASSERT (gCpu != NULL);
+    //
+    // As with SetUefiImageMemoryAttributes(), only a missing GCD descriptor
+    // is fatal. A CPU Arch Protocol failure on one range does not stop the
+    // others from being applied.
+    //
+    Status = CoreSetMemoryRangeAttributes (Ranges, RangeCount, CACHE_ATTRIBUTE_MASK);
+    ASSERT (Status != EFI_NOT_FOUND);
+    for (Index = 0; Index < RangeCount; Index++) {
+      DEBUG ((
+        DEBUG_INFO,
+        "SetUefiImageMemoryAttributes - 0x%016lx - 0x%016lx (0x%016lx)\n",
+        Ranges[Index].BaseAddress,
+        Ranges[Index].Length,
+        Ranges[Index].Attributes
+        ));
+    }
+    FreePool (Ranges);
+  }
   return ;
 }
 
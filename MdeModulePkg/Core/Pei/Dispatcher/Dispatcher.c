@@ -113,11 +113,14 @@ DiscoverPeimsAndOrderWithApriori (
   }
 
   //
-  // Record PeimCount, allocate buffer for PeimState and FvFileHandles.
+  // Record PeimCount, allocate buffer for PeimState, the PPI list generation of
+  // the last FALSE DEPEX evaluation of each PEIM, and FvFileHandles.
   //
   CoreFileHandle->PeimCount = PeimCount;
   CoreFileHandle->PeimState = AllocateZeroPool (sizeof (UINT8) * PeimCount);
   ASSERT (CoreFileHandle->PeimState != NULL);
+  CoreFileHandle->DepexPpiGeneration = AllocateZeroPool (sizeof (UINTN) * PeimCount);
+  ASSERT (CoreFileHandle->DepexPpiGeneration != NULL);
   CoreFileHandle->FvFileHandles = AllocateZeroPool (sizeof (EFI_PEI_FILE_HANDLE) * PeimCount);
   ASSERT (CoreFileHandle->FvFileHandles != NULL);
 
@@ -1057,6 +1060,7 @@ PeiDispatcher (
     } else {
       Private->PeimDispatcherReenter    = FALSE;
     }
+    Private->DispatchPassCount++;
 
     for (FvCount = Private->CurrentPeimFvCount; FvCount < Private->FvCount; FvCount++) {
       CoreFvHandle = FindNextCoreFvHandle (Private, FvCount);
@@ -1090,7 +1094,17 @@ PeiDispatcher (
         PeimFileHandle = Private->CurrentFileHandle = Private->CurrentFvFileHandles[PeimCount];
 
         if (Private->Fv[FvCount].PeimState[PeimCount] == PEIM_STATE_NOT_DISPATCHED) {
-          if (!DepexSatisfied (Private, PeimFileHandle, PeimCount)) {
+          if ((Private->Fv[FvCount].DepexPpiGeneration[PeimCount] != 0) &&
+              (Private->Fv[FvCount].DepexPpiGeneration[PeimCount] == Private->PpiData.PpiList.Generation)) {
+            //
+            // A DEPEX only depends on the installed PPIs, and PPIs can not be
+            // uninstalled. If no PPI has been installed or reinstalled since
+            // the DEPEX was evaluated to FALSE, it is still FALSE.
+            //
+            Private->DepexSkipCount++;
+            Private->PeimNeedingDispatch = TRUE;
+          } else if (!DepexSatisfied (Private, PeimFileHandle, PeimCount)) {
+            Private->Fv[FvCount].DepexPpiGeneration[PeimCount] = Private->PpiData.PpiList.Generation;
             Private->PeimNeedingDispatch = TRUE;
           } else {
             Status = CoreFvHandle->FvPpi->GetFileInfo (CoreFvHandle->FvPpi, PeimFileHandle, &FvFileInfo);
@@ -1252,6 +1266,13 @@ PeiDispatcher (
     //
   } while (Private->PeimNeedingDispatch && Private->PeimDispatchOnThisPass);
 
+  DEBUG ((
+    DEBUG_INFO,
+    "PEI dispatcher: %Lu pass(es), %Lu DEPEX evaluation(s), %Lu DEPEX evaluation(s) skipped\n",
+    (UINT64) Private->DispatchPassCount,
+    (UINT64) Private->DepexEvaluationCount,
+    (UINT64) Private->DepexSkipCount
+    ));
 }
 
 /**
@@ -1308,6 +1329,8 @@ DepexSatisfied (
   VOID                 *DepexData;
   EFI_FV_FILE_INFO     FileInfo;
 
+  Private->DepexEvaluationCount++;
+
   Status = PeiServicesFfsGetFileInfo (FileHandle, &FileInfo);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_DISPATCH, "Evaluate PEI DEPEX for FFS(Unknown)\n"));
@@ -262,7 +262,7 @@ FileHandleToVolume (
 
 **/
 EFI_STATUS
-FindFileEx (
+FindFileInFvHeaders (
   IN  CONST EFI_PEI_FV_HANDLE        FvHandle,
   IN  CONST EFI_GUID                 *FileName,   OPTIONAL
   IN        EFI_FV_FILETYPE          SearchType,
@@ -446,6 +446,209 @@ FindFileEx (
   return EFI_NOT_FOUND;
 }
 
+/**
+  Given the input file pointer, search for the first matching file in the
+  file index of the FV. It follows the same search rules as FindFileInFvHeaders(),
+  but does not touch the FV contents except for the returned file.
+
+  @param CoreFvHandle    Pointer to the indexed PEI_CORE_FV_HANDLE.
+  @param FileName        File name
+  @param SearchType      Filter to find only files of this type.
+                         Type EFI_FV_FILETYPE_ALL causes no filtering to be done.
+  @param FileHandle      This parameter must point to a valid FFS volume.
+  @param AprioriFile     Pointer to AprioriFile image in this FV if has
+
+  @return EFI_NOT_FOUND  No files matching the search criteria were found
+  @retval EFI_SUCCESS    Success to search given file
+
+**/
+EFI_STATUS
+FindFileInFileIndex (
+  IN        PEI_CORE_FV_HANDLE       *CoreFvHandle,
+  IN  CONST EFI_GUID                 *FileName,   OPTIONAL
+  IN        EFI_FV_FILETYPE          SearchType,
+  IN OUT    EFI_PEI_FILE_HANDLE      *FileHandle,
+  IN OUT    EFI_PEI_FILE_HANDLE      *AprioriFile  OPTIONAL
+  )
+{
+  PEI_CORE_FV_FILE_ENTRY                *Entry;
+  UINT8                                 *FvBase;
+  UINTN                                 Index;
+  UINTN                                 Low;
+  UINTN                                 High;
+  UINTN                                 Middle;
+  UINTN                                 Offset;
+
+  FvBase = (UINT8 *) CoreFvHandle->FvHandle;
+
+  //
+  // If FileHeader is not specified (NULL) or FileName is not NULL,
+  // start with the first file in the firmware volume. Otherwise,
+  // start from the first file located after FileHeader.
+  //
+  Index = 0;
+  if ((*FileHandle != NULL) && (FileName == NULL)) {
+    Offset = (UINTN) ((UINT8 *) *FileHandle - FvBase);
+    Low    = 0;
+    High   = CoreFvHandle->FileCount;
+    while (Low < High) {
+      Middle = (Low + High) / 2;
+      if (CoreFvHandle->FileIndex[Middle].Offset <= Offset) {
+        Low = Middle + 1;
+      } else {
+        High = Middle;
+      }
+    }
+    Index = Low;
+  }
+
+  for (; Index < CoreFvHandle->FileCount; Index++) {
+    Entry = &CoreFvHandle->FileIndex[Index];
+    if (FileName != NULL) {
+      if (CompareGuid (&Entry->Name, FileName)) {
+        *FileHandle = (EFI_PEI_FILE_HANDLE) (FvBase + Entry->Offset);
+        return EFI_SUCCESS;
+      }
+    } else if (SearchType == PEI_CORE_INTERNAL_FFS_FILE_DISPATCH_TYPE) {
+      if ((Entry->Type == EFI_FV_FILETYPE_PEIM) ||
+          (Entry->Type == EFI_FV_FILETYPE_COMBINED_PEIM_DRIVER) ||
+          (Entry->Type == EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE)) {
+        *FileHandle = (EFI_PEI_FILE_HANDLE) (FvBase + Entry->Offset);
+        return EFI_SUCCESS;
+      } else if (AprioriFile != NULL) {
+        if ((Entry->Type == EFI_FV_FILETYPE_FREEFORM) &&
+            CompareGuid (&Entry->Name, &gPeiAprioriFileNameGuid)) {
+          *AprioriFile = (EFI_PEI_FILE_HANDLE) (FvBase + Entry->Offset);
+        }
+      }
+    } else if ((SearchType == Entry->Type) || (SearchType == EFI_FV_FILETYPE_ALL)) {
+      *FileHandle = (EFI_PEI_FILE_HANDLE) (FvBase + Entry->Offset);
+      return EFI_SUCCESS;
+    }
+  }
+
+  *FileHandle = NULL;
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Given the input file pointer, search for the first matching file in the
+  FFS volume as defined by SearchType. The search starts from FileHeader inside
+  the Firmware Volume defined by FwVolHeader.
+  If SearchType is EFI_FV_FILETYPE_ALL, the first FFS file will return without check its file type.
+  If SearchType is PEI_CORE_INTERNAL_FFS_FILE_DISPATCH_TYPE,
+  the first PEIM, or COMBINED PEIM or FV file type FFS file will return.
+
+  The file index of the FV is used when it has been built, otherwise the FFS
+  file headers in the FV are walked.
+
+  @param FvHandle        Pointer to the FV header of the volume to search
+  @param FileName        File name
+  @param SearchType      Filter to find only files of this type.
+                         Type EFI_FV_FILETYPE_ALL causes no filtering to be done.
+  @param FileHandle      This parameter must point to a valid FFS volume.
+  @param AprioriFile     Pointer to AprioriFile image in this FV if has
+
+  @return EFI_NOT_FOUND  No files matching the search criteria were found
+  @retval EFI_SUCCESS    Success to search given file
+
+**/
+EFI_STATUS
+FindFileEx (
+  IN  CONST EFI_PEI_FV_HANDLE        FvHandle,
+  IN  CONST EFI_GUID                 *FileName,   OPTIONAL
+  IN        EFI_FV_FILETYPE          SearchType,
+  IN OUT    EFI_PEI_FILE_HANDLE      *FileHandle,
+  IN OUT    EFI_PEI_FILE_HANDLE      *AprioriFile  OPTIONAL
+  )
+{
+  PEI_CORE_FV_HANDLE                    *CoreFvHandle;
+
+  CoreFvHandle = FvHandleToCoreHandle (FvHandle);
+  if ((CoreFvHandle != NULL) && (CoreFvHandle->FileIndex != NULL)) {
+    return FindFileInFileIndex (CoreFvHandle, FileName, SearchType, FileHandle, AprioriFile);
+  }
+
+  return FindFileInFvHeaders (FvHandle, FileName, SearchType, FileHandle, AprioriFile);
+}
+
+/**
+  Build the file index of a FV in FFS2 or FFS3 format.
+
+  The FFS file headers in the FV are walked and validated in a single pass, and
+  the name, type and offset of every file are recorded, so that later file
+  lookups in the FV do not need to walk the FV again. The FV is left unindexed if the
+  index can not be allocated.
+
+  @param CoreFvHandle    Pointer to the PEI_CORE_FV_HANDLE of the FV.
+
+**/
+VOID
+BuildFvFileIndex (
+  IN PEI_CORE_FV_HANDLE              *CoreFvHandle
+  )
+{
+  EFI_STATUS                         Status;
+  EFI_PEI_FILE_HANDLE                FileHandle;
+  EFI_FFS_FILE_HEADER                *FfsFileHeader;
+  PEI_CORE_FV_FILE_ENTRY             *FileIndex;
+  PEI_CORE_FV_FILE_ENTRY             *TempIndex;
+  UINTN                              FileCount;
+  UINTN                              MaxFileCount;
+
+  //
+  // Only the FV formats produced by PeiCore can be walked by FindFileInFvHeaders().
+  //
+  if ((CoreFvHandle->FvPpi != &mPeiFfs2FwVol.Fv) && (CoreFvHandle->FvPpi != &mPeiFfs3FwVol.Fv)) {
+    return;
+  }
+
+  FileIndex = AllocatePool (sizeof (PEI_CORE_FV_FILE_ENTRY) * FV_FILE_INDEX_INITIAL_COUNT);
+  if (FileIndex == NULL) {
+    return;
+  }
+  MaxFileCount = FV_FILE_INDEX_INITIAL_COUNT;
+
+  FileCount  = 0;
+  FileHandle = NULL;
+  while (TRUE) {
+    Status = FindFileInFvHeaders (CoreFvHandle->FvHandle, NULL, EFI_FV_FILETYPE_ALL, &FileHandle, NULL);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    if (FileCount >= MaxFileCount) {
+      //
+      // Run out of room, grow the buffer. It is doubled so that the buffers left
+      // behind take no more pool than the final one.
+      //
+      TempIndex = AllocatePool (sizeof (PEI_CORE_FV_FILE_ENTRY) * MaxFileCount * 2);
+      if (TempIndex == NULL) {
+        FreePool (FileIndex);
+        return;
+      }
+      CopyMem (TempIndex, FileIndex, sizeof (PEI_CORE_FV_FILE_ENTRY) * MaxFileCount);
+      FreePool (FileIndex);
+      FileIndex    = TempIndex;
+      MaxFileCount = MaxFileCount * 2;
+    }
+
+    FfsFileHeader = (EFI_FFS_FILE_HEADER *) FileHandle;
+    CopyGuid (&FileIndex[FileCount].Name, &FfsFileHeader->Name);
+    FileIndex[FileCount].Offset = (UINT32) ((UINT8 *) FfsFileHeader - (UINT8 *) CoreFvHandle->FvHandle);
+    FileIndex[FileCount].Type   = FfsFileHeader->Type;
+    FileCount++;
+  }
+
+  if (FileCount == 0) {
+    FreePool (FileIndex);
+    return;
+  }
+
+  CoreFvHandle->FileIndex = FileIndex;
+  CoreFvHandle->FileCount = FileCount;
+}
+
 /**
   Initialize PeiCore FV List.
 
@@ -508,6 +711,7 @@ PeiInitializeFv (
   PrivateData->Fv[PrivateData->FvCount].FvPpi    = FvPpi;
   PrivateData->Fv[PrivateData->FvCount].FvHandle = FvHandle;
   PrivateData->Fv[PrivateData->FvCount].AuthenticationStatus = 0;
+  BuildFvFileIndex (&PrivateData->Fv[PrivateData->FvCount]);
   DEBUG ((
     EFI_D_INFO,
     "The %dth FV start address is 0x%11p, size is 0x%08x, handle is 0x%p\n",
@@ -649,6 +853,7 @@ FirmwareVolumeInfoPpiNotifyCallback (
     PrivateData->Fv[PrivateData->FvCount].FvPpi    = FvPpi;
     PrivateData->Fv[PrivateData->FvCount].FvHandle = FvHandle;
     PrivateData->Fv[PrivateData->FvCount].AuthenticationStatus = FvInfo2Ppi.AuthenticationStatus;
+    BuildFvFileIndex (&PrivateData->Fv[PrivateData->FvCount]);
     CurFvCount = PrivateData->FvCount;
     DEBUG ((
       EFI_D_INFO,
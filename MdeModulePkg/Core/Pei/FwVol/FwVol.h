@@ -302,6 +302,66 @@ FindFileEx (
   IN OUT    EFI_PEI_FILE_HANDLE      *AprioriFile  OPTIONAL
   );
 
+/**
+  Given the input file pointer, search for the next matching file in the
+  FFS volume by walking the FFS file headers inside the Firmware Volume
+  defined by FvHandle.
+
+  @param FvHandle        Pointer to the FV header of the volume to search
+  @param FileName        File name
+  @param SearchType      Filter to find only files of this type.
+                         Type EFI_FV_FILETYPE_ALL causes no filtering to be done.
+  @param FileHandle      This parameter must point to a valid FFS volume.
+  @param AprioriFile     Pointer to AprioriFile image in this FV if has
+
+  @return EFI_NOT_FOUND  No files matching the search criteria were found
+  @retval EFI_SUCCESS    Success to search given file
+
+**/
+EFI_STATUS
+FindFileInFvHeaders (
+  IN  CONST EFI_PEI_FV_HANDLE        FvHandle,
+  IN  CONST EFI_GUID                 *FileName,   OPTIONAL
+  IN        EFI_FV_FILETYPE          SearchType,
+  IN OUT    EFI_PEI_FILE_HANDLE      *FileHandle,
+  IN OUT    EFI_PEI_FILE_HANDLE      *AprioriFile  OPTIONAL
+  );
+
+/**
+  Given the input file pointer, search for the next matching file in the
+  file index of the FV.
+
+  @param CoreFvHandle    Pointer to the indexed PEI_CORE_FV_HANDLE.
+  @param FileName        File name
+  @param SearchType      Filter to find only files of this type.
+                         Type EFI_FV_FILETYPE_ALL causes no filtering to be done.
+  @param FileHandle      This parameter must point to a valid FFS volume.
+  @param AprioriFile     Pointer to AprioriFile image in this FV if has
+
+  @return EFI_NOT_FOUND  No files matching the search criteria were found
+  @retval EFI_SUCCESS    Success to search given file
+
+**/
+EFI_STATUS
+FindFileInFileIndex (
+  IN        PEI_CORE_FV_HANDLE       *CoreFvHandle,
+  IN  CONST EFI_GUID                 *FileName,   OPTIONAL
+  IN        EFI_FV_FILETYPE          SearchType,
+  IN OUT    EFI_PEI_FILE_HANDLE      *FileHandle,
+  IN OUT    EFI_PEI_FILE_HANDLE      *AprioriFile  OPTIONAL
+  );
+
+/**
+  Build the file index of a FV in FFS2 or FFS3 format.
+
+  @param CoreFvHandle    Pointer to the PEI_CORE_FV_HANDLE of the FV.
+
+**/
+VOID
+BuildFvFileIndex (
+  IN PEI_CORE_FV_HANDLE              *CoreFvHandle
+  );
+
 /**
   Report the information for a newly discovered FV in an unknown format.
 
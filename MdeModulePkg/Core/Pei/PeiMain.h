@@ -72,6 +72,10 @@ typedef struct {
   UINTN                 MaxCount;
   UINTN                 LastDispatchedCount;
   ///
+  /// Incremented each time a PPI is installed or reinstalled.
+  ///
+  UINTN                 Generation;
+  ///
   /// MaxCount number of entries.
   ///
   PEI_PPI_LIST_POINTERS *PpiPtrs;
@@ -130,6 +134,22 @@ typedef struct {
 //
 #define FV_GROWTH_STEP 8
 
+//
+// Initial number of entries of a FV file index, doubled each time we run out of room
+//
+#define FV_FILE_INDEX_INITIAL_COUNT 64
+
+//
+// One entry of the file index built for a FV in FFS2 or FFS3 format.
+// Offset is relative to the FV handle, so the index stays valid when the
+// FV is accessed through a different mapping.
+//
+typedef struct {
+  EFI_GUID                            Name;
+  UINT32                              Offset;
+  EFI_FV_FILETYPE                     Type;
+} PEI_CORE_FV_FILE_ENTRY;
+
 typedef struct {
   EFI_FIRMWARE_VOLUME_HEADER          *FvHeader;
   EFI_PEI_FIRMWARE_VOLUME_PPI         *FvPpi;
@@ -143,8 +163,20 @@ typedef struct {
   // Pointer to the buffer with the PeimCount number of Entries.
   //
   EFI_PEI_FILE_HANDLE                 *FvFileHandles;
+  //
+  // Pointer to the buffer with the PeimCount number of Entries. Each entry is
+  // the PPI list Generation when the DEPEX of the PEIM was last evaluated to
+  // FALSE, or 0 if it has not been evaluated to FALSE yet.
+  //
+  UINTN                               *DepexPpiGeneration;
   BOOLEAN                             ScanFv;
   UINT32                              AuthenticationStatus;
+  //
+  // Pointer to the buffer with the FileCount number of entries, sorted by
+  // Offset. NULL if the FV is not indexed.
+  //
+  PEI_CORE_FV_FILE_ENTRY              *FileIndex;
+  UINTN                               FileCount;
 } PEI_CORE_FV_HANDLE;
 
 typedef struct {
@@ -307,6 +339,13 @@ struct _PEI_CORE_INSTANCE {
   // Those Memory Range will be migrated into physical memory.
   //
   HOLE_MEMORY_DATA                  HoleData[HOLE_MAX_NUMBER];
+
+  //
+  // Statistics of the PEIM dispatcher, reported when the dispatcher returns.
+  //
+  UINTN                             DispatchPassCount;
+  UINTN                             DepexEvaluationCount;
+  UINTN                             DepexSkipCount;
 };
 
 ///
@@ -225,9 +225,15 @@ PeiCore (
           if (OldCoreData->Fv[Index].PeimState != NULL) {
             OldCoreData->Fv[Index].PeimState     = (UINT8 *) OldCoreData->Fv[Index].PeimState + OldCoreData->HeapOffset;
           }
+          if (OldCoreData->Fv[Index].DepexPpiGeneration != NULL) {
+            OldCoreData->Fv[Index].DepexPpiGeneration = (UINTN *) ((UINT8 *) OldCoreData->Fv[Index].DepexPpiGeneration + OldCoreData->HeapOffset);
+          }
           if (OldCoreData->Fv[Index].FvFileHandles != NULL) {
             OldCoreData->Fv[Index].FvFileHandles = (EFI_PEI_FILE_HANDLE *) ((UINT8 *) OldCoreData->Fv[Index].FvFileHandles + OldCoreData->HeapOffset);
           }
+          if (OldCoreData->Fv[Index].FileIndex != NULL) {
+            OldCoreData->Fv[Index].FileIndex     = (PEI_CORE_FV_FILE_ENTRY *) ((UINT8 *) OldCoreData->Fv[Index].FileIndex + OldCoreData->HeapOffset);
+          }
         }
         OldCoreData->TempFileGuid         = (EFI_GUID *) ((UINT8 *) OldCoreData->TempFileGuid + OldCoreData->HeapOffset);
         OldCoreData->TempFileHandles      = (EFI_PEI_FILE_HANDLE *) ((UINT8 *) OldCoreData->TempFileHandles + OldCoreData->HeapOffset);
@@ -253,9 +259,15 @@ PeiCore (
           if (OldCoreData->Fv[Index].PeimState != NULL) {
             OldCoreData->Fv[Index].PeimState     = (UINT8 *) OldCoreData->Fv[Index].PeimState - OldCoreData->HeapOffset;
           }
+          if (OldCoreData->Fv[Index].DepexPpiGeneration != NULL) {
+            OldCoreData->Fv[Index].DepexPpiGeneration = (UINTN *) ((UINT8 *) OldCoreData->Fv[Index].DepexPpiGeneration - OldCoreData->HeapOffset);
+          }
           if (OldCoreData->Fv[Index].FvFileHandles != NULL) {
             OldCoreData->Fv[Index].FvFileHandles = (EFI_PEI_FILE_HANDLE *) ((UINT8 *) OldCoreData->Fv[Index].FvFileHandles - OldCoreData->HeapOffset);
           }
+          if (OldCoreData->Fv[Index].FileIndex != NULL) {
+            OldCoreData->Fv[Index].FileIndex     = (PEI_CORE_FV_FILE_ENTRY *) ((UINT8 *) OldCoreData->Fv[Index].FileIndex - OldCoreData->HeapOffset);
+          }
         }
         OldCoreData->TempFileGuid         = (EFI_GUID *) ((UINT8 *) OldCoreData->TempFileGuid - OldCoreData->HeapOffset);
         OldCoreData->TempFileHandles      = (EFI_PEI_FILE_HANDLE *) ((UINT8 *) OldCoreData->TempFileHandles - OldCoreData->HeapOffset);
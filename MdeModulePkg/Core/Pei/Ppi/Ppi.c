@@ -278,6 +278,7 @@ InternalPeiInstallPpi (
     PpiListPointer->PpiPtrs[Index].Ppi = (EFI_PEI_PPI_DESCRIPTOR *) PpiList;
     Index++;
     PpiListPointer->CurrentCount++;
+    PpiListPointer->Generation++;
 
     if (Single) {
       //
@@ -394,6 +395,11 @@ PeiReInstallPpi (
   //
   DEBUG((EFI_D_INFO, "Reinstall PPI: %g\n", NewPpi->Guid));
   PrivateData->PpiData.PpiList.PpiPtrs[Index].Ppi = (EFI_PEI_PPI_DESCRIPTOR *) NewPpi;
+  //
+  // The new PPI may have a different GUID, so it may satisfy a DEPEX that
+  // the old one did not.
+  //
+  PrivateData->PpiData.PpiList.Generation++;
 
   //
   // Process any callback level notifies for the newly installed PPI.
@@ -36,6 +36,19 @@ typedef struct {
   /// This field is used to store the distance of two neighbouring VAR_ADDED type variables.
   /// The meaning of the field is implement-dependent.
   UINT16          Index[VARIABLE_INDEX_TABLE_VOLUME];
+  ///
+  /// This field is used to store a hash of the vendor GUID and name of the variable
+  /// at the same position in Index, so that most variables are skipped without
+  /// reading their name. The meaning of the field is implement-dependent.
+  ///
+  UINT16          Hash[VARIABLE_INDEX_TABLE_VOLUME];
+  ///
+  /// The number of lookups in the indexed variable store, how many of them were
+  /// answered from the index and how many had to walk the variable store.
+  ///
+  UINT32          LookupCount;
+  UINT32          IndexHitCount;
+  UINT32          StoreWalkCount;
 } VARIABLE_INDEX_TABLE;
 
 #endif // __VARIABLE_INDEX_TABLE_H__
@@ -0,0 +1,38 @@
+/** @file
+  The reclaim statistics of the non-volatile variable store are related to
+  EDK II-specific implementation of UEFI variables.
+
+  When PcdVariableCollectStatistics is TRUE, the variable driver publishes a
+  VARIABLE_RECLAIM_STATISTICS structure in the EFI System Table with this GUID
+  at ReadyToBoot.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __VARIABLE_RECLAIM_STATISTICS_H__
+#define __VARIABLE_RECLAIM_STATISTICS_H__
+
+#define EDKII_VARIABLE_RECLAIM_STATISTICS_GUID \
+  { 0x5838a294, 0xcf61, 0x4c99, { 0x84, 0x32, 0x84, 0x51, 0x23, 0x91, 0x5c, 0x6d } }
+
+typedef struct {
+  ///
+  /// Number of reclaims of the non-volatile variable store.
+  ///
+  UINT32                  ReclaimCount;
+  ///
+  /// Number of bytes written to flash by the reclaims.
+  ///
+  UINT64                  BytesWritten;
+  ///
+  /// Total and longest time in nanoseconds spent in a reclaim. Both are 0 if the
+  /// performance counter does not report a frequency.
+  ///
+  UINT64                  TotalTime;
+  UINT64                  MaxTime;
+} VARIABLE_RECLAIM_STATISTICS;
+
+extern EFI_GUID gEdkiiVariableReclaimStatisticsGuid;
+
+#endif
@@ -0,0 +1,96 @@
+/** @file
+  Pool Statistics Protocol reports how the DXE Core pool allocator is using
+  memory for each memory type and pool size class.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __POOL_STATISTICS_H__
+#define __POOL_STATISTICS_H__
+
+//{2B1D6F5C-8E1A-4F0C-9C57-3A0E5D7B94C1}
+#define EDKII_POOL_STATISTICS_PROTOCOL_GUID \
+  { \
+    0x2b1d6f5c, 0x8e1a, 0x4f0c, { 0x9c, 0x57, 0x3a, 0x0e, 0x5d, 0x7b, 0x94, 0xc1 } \
+  }
+
+#define EDKII_POOL_STATISTICS_PROTOCOL_REVISION  0x00010000
+
+typedef struct _EDKII_POOL_STATISTICS_PROTOCOL EDKII_POOL_STATISTICS_PROTOCOL;
+
+///
+/// Usage of one pool size class of one memory type.
+///
+typedef struct {
+  ///
+  /// Size in bytes of each block of this class, including the pool header and
+  /// tail. Zero for the class of allocations served directly from pages.
+  ///
+  UINT64    BlockSize;
+  ///
+  /// Number of blocks currently allocated.
+  ///
+  UINT64    LiveBlocks;
+  ///
+  /// Number of bytes usable by callers in the blocks currently allocated.
+  ///
+  UINT64    LiveBytes;
+  ///
+  /// Number of bytes in the blocks currently allocated that are not usable by
+  /// callers: pool header and tail, and rounding up to the block size.
+  ///
+  UINT64    WastedBytes;
+  ///
+  /// Number of free blocks of this class, on the free list or left in the
+  /// slabs of this class when the DXE Core uses the slab pool allocator.
+  ///
+  UINT64    FreeBlocks;
+  ///
+  /// Number of allocations served from this class since boot.
+  ///
+  UINT64    TotalAllocations;
+} EDKII_POOL_CLASS_STATISTICS;
+
+/**
+  Retrieve the pool usage of one memory type.
+
+  @param[in]      This              The EDKII_POOL_STATISTICS_PROTOCOL instance.
+  @param[in]      MemoryType        The memory type to report.
+  @param[in, out] ClassCount        On input, the number of entries in ClassStatistics.
+                                    On output, the number of pool size classes.
+  @param[out]     ClassStatistics   The usage of each pool size class. The last
+                                    entry describes allocations served directly
+                                    from pages.
+  @param[out]     PoolPages         The number of pages currently owned by the pool
+                                    allocator to serve allocations of MemoryType
+                                    from the size classes. Optional.
+
+  @retval EFI_SUCCESS               The statistics were returned.
+  @retval EFI_INVALID_PARAMETER     ClassCount is NULL.
+  @retval EFI_INVALID_PARAMETER     ClassStatistics is NULL and *ClassCount is not 0.
+  @retval EFI_NOT_FOUND             The pool allocator does not track MemoryType. It
+                                    is a reserved memory type, or an OEM or OS loader
+                                    memory type that has no pool yet.
+  @retval EFI_BUFFER_TOO_SMALL      *ClassCount is too small. It has been updated
+                                    with the number of classes.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_POOL_STATISTICS_GET)(
+  IN     EDKII_POOL_STATISTICS_PROTOCOL   *This,
+  IN     EFI_MEMORY_TYPE                  MemoryType,
+  IN OUT UINTN                            *ClassCount,
+  OUT    EDKII_POOL_CLASS_STATISTICS      *ClassStatistics,
+  OUT    UINT64                           *PoolPages OPTIONAL
+  );
+
+struct _EDKII_POOL_STATISTICS_PROTOCOL {
+  UINT64                        Revision;
+  EDKII_POOL_STATISTICS_GET     GetStatistics;
+};
+
+extern EFI_GUID gEdkiiPoolStatisticsProtocolGuid;
+
+#endif
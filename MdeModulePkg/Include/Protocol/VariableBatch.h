@@ -0,0 +1,89 @@
+/** @file
+  Variable Batch Protocol is related to EDK II-specific implementation of variables
+  and intended for use as a means to write a group of non-volatile variable updates
+  to flash in one Fault Tolerant Write transaction.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __VARIABLE_BATCH_H__
+#define __VARIABLE_BATCH_H__
+
+#define EDKII_VARIABLE_BATCH_PROTOCOL_GUID \
+  { \
+    0x7639470c, 0xe625, 0x4b2c, { 0xb0, 0x95, 0x3b, 0xdd, 0x62, 0x7e, 0x82, 0xee } \
+  }
+
+typedef struct _EDKII_VARIABLE_BATCH_PROTOCOL  EDKII_VARIABLE_BATCH_PROTOCOL;
+
+///
+/// One variable update of a batch, the parameters have the same meaning as those
+/// of SetVariable ().
+///
+typedef struct {
+  CHAR16      *VariableName;
+  EFI_GUID    *VendorGuid;
+  UINT32      Attributes;
+  UINTN       DataSize;
+  VOID        *Data;
+} EDKII_VARIABLE_BATCH_UPDATE;
+
+/**
+  Apply a list of variable updates and write them to flash together.
+
+  The updates are applied in order as by SetVariable (). They are only applied
+  to the memory copy of the variable store, and are written to flash in one Fault
+  Tolerant Write transaction before the function returns. Either all or none of
+  the updates are written: if an update fails, or the transaction cannot be
+  written, the memory copy is reloaded from flash. Variable updates of other
+  callers are not part of the batch.
+
+  Only non-volatile variables can be part of a batch. Authenticated variables,
+  hardware error records, appended data and the PlatformLangCodes, LangCodes,
+  PlatformLang and Lang variables cannot, they must be written through
+  SetVariable (). A variable is deleted by an update with a DataSize of zero and
+  the attributes of the variable.
+
+  The function must be called at or below TPL_CALLBACK, as SetVariable ().
+
+  @param[in] This          The EDKII_VARIABLE_BATCH_PROTOCOL instance.
+  @param[in] UpdateCount   The number of entries in Updates.
+  @param[in] Updates       The variable updates to apply.
+
+  @retval EFI_SUCCESS           All the updates were written.
+  @retval EFI_INVALID_PARAMETER Updates is NULL and UpdateCount is not zero, or
+                                an update has a NULL or empty name, a NULL vendor
+                                GUID, a NULL Data with a non-zero DataSize, or a
+                                size above the maximum variable size, or it is
+                                not allowed in a batch. No update was applied.
+  @retval EFI_OUT_OF_RESOURCES  The updates do not fit in the variable store. No
+                                update was applied.
+  @retval EFI_UNSUPPORTED       The variable write service is not ready yet, the
+                                function is called at OS runtime, or it is called
+                                above TPL_CALLBACK, or the variable driver cannot
+                                roll a batch back in its current state.
+  @retval Others                An update failed with this status as returned by
+                                SetVariable (), or the updates could not be
+                                written. No update was applied.
+**/
+typedef
+EFI_STATUS
+(EFIAPI * EDKII_VARIABLE_BATCH_PROTOCOL_SET_VARIABLES) (
+  IN CONST EDKII_VARIABLE_BATCH_PROTOCOL  *This,
+  IN       UINTN                          UpdateCount,
+  IN       EDKII_VARIABLE_BATCH_UPDATE    *Updates
+  );
+
+///
+/// Variable Batch Protocol is related to EDK II-specific implementation of variables
+/// and intended for use as a means to write a group of non-volatile variable updates
+/// to flash in one Fault Tolerant Write transaction.
+///
+struct _EDKII_VARIABLE_BATCH_PROTOCOL {
+  EDKII_VARIABLE_BATCH_PROTOCOL_SET_VARIABLES  SetVariables;
+};
+
+extern EFI_GUID gEdkiiVariableBatchProtocolGuid;
+
+#endif
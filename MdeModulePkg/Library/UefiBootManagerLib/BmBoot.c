@@ -2281,6 +2281,228 @@ BmEnumerateBootOptions (
   return BootOptions;
 }
 
+/**
+  Check whether a boot option in NV was added by BDS and its device is gone.
+
+  Only those added by BDS are checked, so that the boot options added by
+  end-user or OS installer won't be deleted.
+
+  @param NvBootOption      The boot option in NV.
+  @param BootOptions       The enumerated boot options.
+  @param BootOptionCount   The number of the enumerated boot options.
+
+  @retval TRUE   The boot option should be removed from NV.
+  @retval FALSE  The boot option should be kept.
+**/
+BOOLEAN
+BmIsInvalidAutoCreateBootOption (
+  IN EFI_BOOT_MANAGER_LOAD_OPTION  *NvBootOption,
+  IN EFI_BOOT_MANAGER_LOAD_OPTION  *BootOptions,
+  IN UINTN                         BootOptionCount
+  )
+{
+  if ((DevicePathType (NvBootOption->FilePath) == BBS_DEVICE_PATH) &&
+      (DevicePathSubType (NvBootOption->FilePath) == BBS_BBS_DP)) {
+    return FALSE;
+  }
+
+  return (BOOLEAN) (BmIsAutoCreateBootOption (NvBootOption) &&
+                    (EfiBootManagerFindLoadOption (NvBootOption, BootOptions, BootOptionCount) == -1));
+}
+
+/**
+  Remove the invalid EFI boot options from NV and add the new ones, through one
+  call to the variable batch protocol.
+
+  The Boot#### and BootOrder updates are collected the same way as
+  EfiBootManagerDeleteLoadOptionVariable () and EfiBootManagerAddLoadOptionVariable ()
+  would do them one by one, and written to flash together.
+
+  @param VariableBatch       The EDKII_VARIABLE_BATCH_PROTOCOL instance.
+  @param NvBootOptions       The boot options in NV.
+  @param NvBootOptionCount   The number of the boot options in NV.
+  @param BootOptions         The enumerated boot options.
+  @param BootOptionCount     The number of the enumerated boot options.
+
+  @retval EFI_SUCCESS           The boot options were updated.
+  @retval EFI_OUT_OF_RESOURCES  There is not enough memory to collect the updates.
+  @return Others                Status of EDKII_VARIABLE_BATCH_PROTOCOL.SetVariables (),
+                                no boot option was updated.
+**/
+EFI_STATUS
+BmRefreshBootOptionVariables (
+  IN EDKII_VARIABLE_BATCH_PROTOCOL *VariableBatch,
+  IN EFI_BOOT_MANAGER_LOAD_OPTION  *NvBootOptions,
+  IN UINTN                         NvBootOptionCount,
+  IN EFI_BOOT_MANAGER_LOAD_OPTION  *BootOptions,
+  IN UINTN                         BootOptionCount
+  )
+{
+  EFI_STATUS                       Status;
+  UINT16                           *BootOrder;
+  UINTN                            BootOrderSize;
+  UINT16                           *NewBootOrder;
+  UINTN                            NewBootOrderCount;
+  BOOLEAN                          BootOrderChanged;
+  UINT16                           *BootNext;
+  EDKII_VARIABLE_BATCH_UPDATE      *Updates;
+  UINTN                            UpdateCount;
+  UINTN                            OptionUpdateCount;
+  CHAR16                           *OptionNames;
+  UINTN                            Index;
+  UINTN                            OrderIndex;
+  UINTN                            OptionNumber;
+
+  GetEfiGlobalVariable2 (EFI_BOOT_ORDER_VARIABLE_NAME, (VOID **) &BootOrder, &BootOrderSize);
+  ASSERT ((BootOrder != NULL && BootOrderSize != 0) || (BootOrder == NULL && BootOrderSize == 0));
+  GetEfiGlobalVariable2 (L"BootNext", (VOID **) &BootNext, NULL);
+
+  //
+  // At most one update per boot option, and one for BootOrder.
+  //
+  NewBootOrder = AllocatePool (BootOrderSize + (BootOptionCount + 1) * sizeof (UINT16));
+  Updates      = AllocatePool ((NvBootOptionCount + BootOptionCount + 1) * sizeof (EDKII_VARIABLE_BATCH_UPDATE));
+  OptionNames  = AllocatePool ((NvBootOptionCount + BootOptionCount + 1) * BM_OPTION_NAME_LEN * sizeof (CHAR16));
+  if ((NewBootOrder == NULL) || (Updates == NULL) || (OptionNames == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  if (BootOrderSize != 0) {
+    CopyMem (NewBootOrder, BootOrder, BootOrderSize);
+  }
+  NewBootOrderCount = BootOrderSize / sizeof (UINT16);
+  BootOrderChanged  = FALSE;
+  UpdateCount       = 0;
+
+  //
+  // Remove invalid EFI boot options from NV
+  //
+  for (Index = 0; Index < NvBootOptionCount; Index++) {
+    if (!BmIsInvalidAutoCreateBootOption (&NvBootOptions[Index], BootOptions, BootOptionCount)) {
+      continue;
+    }
+
+    for (OrderIndex = 0; OrderIndex < NewBootOrderCount; OrderIndex++) {
+      if (NewBootOrder[OrderIndex] == NvBootOptions[Index].OptionNumber) {
+        NewBootOrderCount--;
+        CopyMem (
+          &NewBootOrder[OrderIndex],
+          &NewBootOrder[OrderIndex + 1],
+          (NewBootOrderCount - OrderIndex) * sizeof (UINT16)
+          );
+        BootOrderChanged = TRUE;
+        break;
+      }
+    }
+
+    UnicodeSPrint (
+      &OptionNames[UpdateCount * BM_OPTION_NAME_LEN], BM_OPTION_NAME_LEN * sizeof (CHAR16), L"%s%04x",
+      mBmLoadOptionName[LoadOptionTypeBoot], NvBootOptions[Index].OptionNumber
+      );
+    Updates[UpdateCount].VariableName = &OptionNames[UpdateCount * BM_OPTION_NAME_LEN];
+    Updates[UpdateCount].VendorGuid   = &gEfiGlobalVariableGuid;
+    Updates[UpdateCount].Attributes   = EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS | EFI_VARIABLE_NON_VOLATILE;
+    Updates[UpdateCount].DataSize     = 0;
+    Updates[UpdateCount].Data         = NULL;
+    UpdateCount++;
+  }
+
+  //
+  // Add new EFI boot options to NV, each is appended to BootOrder. An option
+  // without a number takes the minimal option number that is neither in
+  // BootOrder nor BootNext. BootOptions is not modified, so that the options
+  // can still be added one by one if the batch fails.
+  //
+  for (Index = 0; Index < BootOptionCount; Index++) {
+    if (EfiBootManagerFindLoadOption (&BootOptions[Index], NvBootOptions, NvBootOptionCount) != -1) {
+      continue;
+    }
+
+    if (BootOptions[Index].OptionNumber != LoadOptionNumberUnassigned) {
+      OptionNumber = BootOptions[Index].OptionNumber;
+      for (OrderIndex = 0; OrderIndex < NewBootOrderCount; OrderIndex++) {
+        if (NewBootOrder[OrderIndex] == OptionNumber) {
+          break;
+        }
+      }
+      if ((OptionNumber >= LoadOptionNumberMax) || (OrderIndex != NewBootOrderCount)) {
+        //
+        // The option number is invalid or being used already.
+        //
+        continue;
+      }
+    } else {
+      for (OptionNumber = 0; OptionNumber < LoadOptionNumberMax; OptionNumber++) {
+        for (OrderIndex = 0; OrderIndex < NewBootOrderCount; OrderIndex++) {
+          if (NewBootOrder[OrderIndex] == OptionNumber) {
+            break;
+          }
+        }
+        if ((OrderIndex == NewBootOrderCount) && ((BootNext == NULL) || (OptionNumber != *BootNext))) {
+          break;
+        }
+      }
+      if (OptionNumber == LoadOptionNumberMax) {
+        //
+        // Try best to add the boot options, there is no free option number left.
+        //
+        break;
+      }
+    }
+
+    NewBootOrder[NewBootOrderCount++] = (UINT16) OptionNumber;
+    BootOrderChanged                  = TRUE;
+
+    UnicodeSPrint (
+      &OptionNames[UpdateCount * BM_OPTION_NAME_LEN], BM_OPTION_NAME_LEN * sizeof (CHAR16), L"%s%04x",
+      mBmLoadOptionName[LoadOptionTypeBoot], OptionNumber
+      );
+    Updates[UpdateCount].VariableName = &OptionNames[UpdateCount * BM_OPTION_NAME_LEN];
+    Updates[UpdateCount].VendorGuid   = &gEfiGlobalVariableGuid;
+    Updates[UpdateCount].Attributes   = EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS | EFI_VARIABLE_NON_VOLATILE;
+    Updates[UpdateCount].Data         = BmLoadOptionToVariableData (&BootOptions[Index], &Updates[UpdateCount].DataSize);
+    UpdateCount++;
+  }
+  OptionUpdateCount = UpdateCount;
+
+  if (BootOrderChanged) {
+    Updates[UpdateCount].VariableName = EFI_BOOT_ORDER_VARIABLE_NAME;
+    Updates[UpdateCount].VendorGuid   = &gEfiGlobalVariableGuid;
+    Updates[UpdateCount].Attributes   = EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS | EFI_VARIABLE_NON_VOLATILE;
+    Updates[UpdateCount].DataSize     = NewBootOrderCount * sizeof (UINT16);
+    Updates[UpdateCount].Data         = NewBootOrder;
+    UpdateCount++;
+  }
+
+  Status = VariableBatch->SetVariables (VariableBatch, UpdateCount, Updates);
+
+  for (Index = 0; Index < OptionUpdateCount; Index++) {
+    if (Updates[Index].Data != NULL) {
+      FreePool (Updates[Index].Data);
+    }
+  }
+
+Exit:
+  if (NewBootOrder != NULL) {
+    FreePool (NewBootOrder);
+  }
+  if (Updates != NULL) {
+    FreePool (Updates);
+  }
+  if (OptionNames != NULL) {
+    FreePool (OptionNames);
+  }
+  if (BootOrder != NULL) {
+    FreePool (BootOrder);
+  }
+  if (BootNext != NULL) {
+    FreePool (BootNext);
+  }
+
+  return Status;
+}
+
 /**
   The function enumerates all boot options, creates them and registers them in the BootOrder variable.
 **/
@@ -2299,6 +2521,7 @@ EfiBootManagerRefreshAllBootOption (
   UINTN                                UpdatedBootOptionCount;
   UINTN                                Index;
   EDKII_PLATFORM_BOOT_MANAGER_PROTOCOL *PlatformBootManager;
+  EDKII_VARIABLE_BATCH_PROTOCOL        *VariableBatch;
 
   //
   // Optionally refresh the legacy boot option
@@ -2342,18 +2565,24 @@ EfiBootManagerRefreshAllBootOption (
   NvBootOptions = EfiBootManagerGetLoadOptions (&NvBootOptionCount, LoadOptionTypeBoot);
 
   //
-  // Remove invalid EFI boot options from NV
+  // Write the Boot#### and BootOrder updates to flash together when the
+  // variable driver supports batching them.
   //
-  for (Index = 0; Index < NvBootOptionCount; Index++) {
-    if (((DevicePathType (NvBootOptions[Index].FilePath) != BBS_DEVICE_PATH) ||
-         (DevicePathSubType (NvBootOptions[Index].FilePath) != BBS_BBS_DP)
-        ) && BmIsAutoCreateBootOption (&NvBootOptions[Index])
-       ) {
-      //
-      // Only check those added by BDS
-      // so that the boot options added by end-user or OS installer won't be deleted
-      //
-      if (EfiBootManagerFindLoadOption (&NvBootOptions[Index], BootOptions, BootOptionCount) == -1) {
+  Status = gBS->LocateProtocol (&gEdkiiVariableBatchProtocolGuid, NULL, (VOID **) &VariableBatch);
+  if (!EFI_ERROR (Status)) {
+    Status = BmRefreshBootOptionVariables (VariableBatch, NvBootOptions, NvBootOptionCount, BootOptions, BootOptionCount);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN, "[Bds] Failed to update the boot options together - %r, update them one by one\n", Status));
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    //
+    // Remove invalid EFI boot options from NV. A failed batch writes nothing,
+    // so each option is then tried on its own.
+    //
+    for (Index = 0; Index < NvBootOptionCount; Index++) {
+      if (BmIsInvalidAutoCreateBootOption (&NvBootOptions[Index], BootOptions, BootOptionCount)) {
         Status = EfiBootManagerDeleteLoadOptionVariable (NvBootOptions[Index].OptionNumber, LoadOptionTypeBoot);
         //
         // Deleting variable with current variable implementation shouldn't fail.
@@ -2361,17 +2590,17 @@ EfiBootManagerRefreshAllBootOption (
         ASSERT_EFI_ERROR (Status);
       }
     }
-  }
 
-  //
-  // Add new EFI boot options to NV
-  //
-  for (Index = 0; Index < BootOptionCount; Index++) {
-    if (EfiBootManagerFindLoadOption (&BootOptions[Index], NvBootOptions, NvBootOptionCount) == -1) {
-      EfiBootManagerAddLoadOptionVariable (&BootOptions[Index], (UINTN) -1);
-      //
-      // Try best to add the boot options so continue upon failure.
-      //
+    //
+    // Add new EFI boot options to NV
+    //
+    for (Index = 0; Index < BootOptionCount; Index++) {
+      if (EfiBootManagerFindLoadOption (&BootOptions[Index], NvBootOptions, NvBootOptionCount) == -1) {
+        EfiBootManagerAddLoadOptionVariable (&BootOptions[Index], (UINTN) -1);
+        //
+        // Try best to add the boot options so continue upon failure.
+        //
+      }
     }
   }
 
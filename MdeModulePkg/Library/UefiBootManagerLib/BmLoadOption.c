@@ -150,36 +150,24 @@ BmGetFreeOptionNumber (
 }
 
 /**
-  Create the Boot####, Driver####, SysPrep####, PlatformRecovery#### variable
-  from the load option.
+  Build the data of the Boot####, Driver####, SysPrep####, PlatformRecovery####
+  variable from the load option.
 
-  @param  LoadOption      Pointer to the load option.
+  @param  Option          Pointer to the load option.
+  @param  VariableSize    Return the size of the variable data.
 
-  @retval EFI_SUCCESS     The variable was created.
-  @retval Others          Error status returned by RT->SetVariable.
+  @return The variable data, the caller is responsible for freeing it.
 **/
-EFI_STATUS
-EFIAPI
-EfiBootManagerLoadOptionToVariable (
-  IN CONST EFI_BOOT_MANAGER_LOAD_OPTION     *Option
+UINT8 *
+BmLoadOptionToVariableData (
+  IN  CONST EFI_BOOT_MANAGER_LOAD_OPTION    *Option,
+  OUT UINTN                                 *VariableSize
   )
 {
-  EFI_STATUS                       Status;
-  UINTN                            VariableSize;
   UINT8                            *Variable;
   UINT8                            *Ptr;
-  CHAR16                           OptionName[BM_OPTION_NAME_LEN];
   CHAR16                           *Description;
   CHAR16                           NullChar;
-  EDKII_VARIABLE_LOCK_PROTOCOL     *VariableLock;
-  UINT32                           VariableAttributes;
-
-  if ((Option->OptionNumber == LoadOptionNumberUnassigned) ||
-      (Option->FilePath == NULL) ||
-      ((UINT32) Option->OptionType >= LoadOptionTypeMax)
-     ) {
-    return EFI_INVALID_PARAMETER;
-  }
 
   //
   // Convert NULL description to empty description
@@ -205,13 +193,13 @@ FilePathList, but their usage is OSV specific. Each element
 in the array is variable length, and ends at the device path end
 structure.
   */
-  VariableSize = sizeof (Option->Attributes)
-               + sizeof (UINT16)
-               + StrSize (Description)
-               + GetDevicePathSize (Option->FilePath)
-               + Option->OptionalDataSize;
+  *VariableSize = sizeof (Option->Attributes)
+                + sizeof (UINT16)
+                + StrSize (Description)
+                + GetDevicePathSize (Option->FilePath)
+                + Option->OptionalDataSize;
 
-  Variable     = AllocatePool (VariableSize);
+  Variable      = AllocatePool (*VariableSize);
   ASSERT (Variable != NULL);
 
   Ptr             = Variable;
@@ -229,6 +217,40 @@ structure.
 
   CopyMem (Ptr, Option->OptionalData, Option->OptionalDataSize);
 
+  return Variable;
+}
+
+/**
+  Create the Boot####, Driver####, SysPrep####, PlatformRecovery#### variable
+  from the load option.
+
+  @param  LoadOption      Pointer to the load option.
+
+  @retval EFI_SUCCESS     The variable was created.
+  @retval Others          Error status returned by RT->SetVariable.
+**/
+EFI_STATUS
+EFIAPI
+EfiBootManagerLoadOptionToVariable (
+  IN CONST EFI_BOOT_MANAGER_LOAD_OPTION     *Option
+  )
+{
+  EFI_STATUS                       Status;
+  UINTN                            VariableSize;
+  UINT8                            *Variable;
+  CHAR16                           OptionName[BM_OPTION_NAME_LEN];
+  EDKII_VARIABLE_LOCK_PROTOCOL     *VariableLock;
+  UINT32                           VariableAttributes;
+
+  if ((Option->OptionNumber == LoadOptionNumberUnassigned) ||
+      (Option->FilePath == NULL) ||
+      ((UINT32) Option->OptionType >= LoadOptionTypeMax)
+     ) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Variable = BmLoadOptionToVariableData (Option, &VariableSize);
+
   UnicodeSPrint (OptionName, sizeof (OptionName), L"%s%04x", mBmLoadOptionName[Option->OptionType], Option->OptionNumber);
 
   VariableAttributes = EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS | EFI_VARIABLE_NON_VOLATILE;
@@ -40,6 +40,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/DriverHealth.h>
 #include <Protocol/FormBrowser2.h>
 #include <Protocol/VariableLock.h>
+#include <Protocol/VariableBatch.h>
 #include <Protocol/RamDisk.h>
 #include <Protocol/DeferredImageLoad.h>
 #include <Protocol/PlatformBootManager.h>
@@ -188,6 +189,21 @@ BmGetFreeOptionNumber (
   OUT UINT16                            *FreeOptionNumber
   );
 
+/**
+  Build the data of the Boot####, Driver####, SysPrep####, PlatformRecovery####
+  variable from the load option.
+
+  @param  Option          Pointer to the load option.
+  @param  VariableSize    Return the size of the variable data.
+
+  @return The variable data, the caller is responsible for freeing it.
+**/
+UINT8 *
+BmLoadOptionToVariableData (
+  IN  CONST EFI_BOOT_MANAGER_LOAD_OPTION    *Option,
+  OUT UINTN                                 *VariableSize
+  );
+
 /**
   This routine adjust the memory information for different memory type and
   save them into the variables for next boot. It resets the system when
@@ -331,6 +331,7 @@ FtwWrite (
   UINTN                               BlockSize;
   UINTN                               NumberOfBlocks;
   UINTN                               NumberOfWriteBlocks;
+  UINTN                               NumberOfSpareWriteBlocks;
   UINTN                               WriteLength;
 
   FtwDevice = FTW_CONTEXT_FROM_THIS (This);
@@ -430,6 +431,18 @@ FtwWrite (
     //
     ASSERT ((BlockSize == FtwDevice->SpareBlockSize) && (NumberOfWriteBlocks == FtwDevice->NumberOfSpareBlock));
   }
+
+  //
+  // Only the spare blocks that hold the new data need to be backed up, erased,
+  // programmed and restored. Working block and boot block updates flush the
+  // whole spare area, so they still go through all of the spare blocks.
+  //
+  if (IsWorkingBlock (FtwDevice, Fvb, Lba) || IsBootBlock (FtwDevice, Fvb)) {
+    NumberOfSpareWriteBlocks = FtwDevice->NumberOfSpareBlock;
+  } else {
+    NumberOfSpareWriteBlocks = FTW_BLOCKS (WriteLength, FtwDevice->SpareBlockSize);
+  }
+
   //
   // Write the record to the work space.
   //
@@ -490,7 +503,7 @@ FtwWrite (
   // Try to keep the content of spare block
   // Save spare block into a spare backup memory buffer (Sparebuffer)
   //
-  SpareBufferSize = FtwDevice->SpareAreaLength;
+  SpareBufferSize = NumberOfSpareWriteBlocks * FtwDevice->SpareBlockSize;
   SpareBuffer     = AllocatePool (SpareBufferSize);
   if (SpareBuffer == NULL) {
     FreePool (MyBuffer);
@@ -498,7 +511,7 @@ FtwWrite (
   }
 
   Ptr = SpareBuffer;
-  for (Index = 0; Index < FtwDevice->NumberOfSpareBlock; Index += 1) {
+  for (Index = 0; Index < NumberOfSpareWriteBlocks; Index += 1) {
     MyLength = FtwDevice->SpareBlockSize;
     Status = FtwDevice->FtwBackupFvb->Read (
                                         FtwDevice->FtwBackupFvb,
@@ -519,7 +532,7 @@ FtwWrite (
   // Write the memory buffer to spare block
   // Do not assume Spare Block and Target Block have same block size
   //
-  Status  = FtwEraseSpareBlock (FtwDevice);
+  Status  = FtwEraseBlock (FtwDevice, FtwDevice->FtwBackupFvb, FtwDevice->FtwSpareLba, NumberOfSpareWriteBlocks);
   if (EFI_ERROR (Status)) {
     FreePool (MyBuffer);
     FreePool (SpareBuffer);
@@ -582,15 +595,21 @@ FtwWrite (
   }
   //
   // Restore spare backup buffer into spare block , if no failure happened during FtwWrite.
+  // Spare blocks that were erased before the write are left erased.
   //
-  Status  = FtwEraseSpareBlock (FtwDevice);
+  Status  = FtwEraseBlock (FtwDevice, FtwDevice->FtwBackupFvb, FtwDevice->FtwSpareLba, NumberOfSpareWriteBlocks);
   if (EFI_ERROR (Status)) {
     FreePool (SpareBuffer);
     return EFI_ABORTED;
   }
   Ptr     = SpareBuffer;
-  for (Index = 0; Index < FtwDevice->NumberOfSpareBlock; Index += 1) {
+  for (Index = 0; Index < NumberOfSpareWriteBlocks; Index += 1) {
     MyLength = FtwDevice->SpareBlockSize;
+    if (IsErasedFlashBuffer (Ptr, MyLength)) {
+      Ptr += MyLength;
+      continue;
+    }
+
     Status = FtwDevice->FtwBackupFvb->Write (
                                         FtwDevice->FtwBackupFvb,
                                         FtwDevice->FtwSpareLba + Index,
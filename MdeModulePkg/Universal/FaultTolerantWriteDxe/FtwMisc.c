@@ -478,23 +478,31 @@ FlushSpareBlockToTargetBlock (
   UINTN       Count;
   UINT8       *Ptr;
   UINTN       Index;
+  UINTN       NumberOfSpareBlocks;
 
   if ((FtwDevice == NULL) || (FvBlock == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
   //
+  // Only the spare blocks covering the target blocks hold the new data.
+  //
+  NumberOfSpareBlocks = FTW_BLOCKS (BlockSize * NumberOfBlocks, FtwDevice->SpareBlockSize);
+  if (NumberOfSpareBlocks > FtwDevice->NumberOfSpareBlock) {
+    return EFI_INVALID_PARAMETER;
+  }
+  //
   // Allocate a memory buffer
   //
-  Length = FtwDevice->SpareAreaLength;
+  Length = NumberOfSpareBlocks * FtwDevice->SpareBlockSize;
   Buffer  = AllocatePool (Length);
   if (Buffer == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
   //
-  // Read all content of spare block to memory buffer
+  // Read the used content of spare block to memory buffer
   //
   Ptr = Buffer;
-  for (Index = 0; Index < FtwDevice->NumberOfSpareBlock; Index += 1) {
+  for (Index = 0; Index < NumberOfSpareBlocks; Index += 1) {
     Count = FtwDevice->SpareBlockSize;
     Status = FtwDevice->FtwBackupFvb->Read (
                                         FtwDevice->FtwBackupFvb,
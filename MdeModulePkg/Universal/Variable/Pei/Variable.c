@@ -566,7 +566,9 @@ GetVariableStore (
   UINT32                                NvStorageSize;
   FAULT_TOLERANT_WRITE_LAST_WRITE_DATA  *FtwLastWriteData;
   UINT32                                BackUpOffset;
+  BOOLEAN                               NewIndexTable;
 
+  NewIndexTable = FALSE;
   StoreInfo->IndexTable = NULL;
   StoreInfo->FtwLastWriteData = NULL;
   StoreInfo->AuthFlag = FALSE;
@@ -648,6 +650,10 @@ GetVariableStore (
           StoreInfo->IndexTable->StartPtr    = GetStartPointer (VariableStoreHeader);
           StoreInfo->IndexTable->EndPtr      = GetEndPointer   (VariableStoreHeader);
           StoreInfo->IndexTable->GoneThrough = 0;
+          StoreInfo->IndexTable->LookupCount    = 0;
+          StoreInfo->IndexTable->IndexHitCount  = 0;
+          StoreInfo->IndexTable->StoreWalkCount = 0;
+          NewIndexTable = TRUE;
         }
       }
       break;
@@ -658,6 +664,13 @@ GetVariableStore (
   }
 
   StoreInfo->VariableStoreHeader = VariableStoreHeader;
+  if (NewIndexTable) {
+    //
+    // Record the VAR_ADDED type variables of the whole variable region in flash
+    // at the first access, so that later lookups do not walk the region again.
+    //
+    BuildVariableIndexTable (StoreInfo);
+  }
   return VariableStoreHeader;
 }
 
@@ -783,6 +796,120 @@ GetVariableNameOrData (
   CopyMem (Buffer, NameOrData, Size);
 }
 
+/**
+  Calculate the hash of a variable vendor GUID and name for the variable index table.
+
+  @param  StoreInfo     Pointer to variable store info structure if the name is in
+                        the variable store, or NULL if the name is in memory.
+  @param  Name          Pointer to the variable name that may be inconsecutive.
+  @param  NameSize      Variable name size, including the null terminator.
+  @param  VendorGuid    Pointer to the variable vendor GUID.
+
+  @return The hash of the vendor GUID and name.
+
+**/
+UINT16
+GetVariableIndexHash (
+  IN VARIABLE_STORE_INFO    *StoreInfo OPTIONAL,
+  IN CONST UINT8            *Name,
+  IN UINTN                  NameSize,
+  IN CONST EFI_GUID         *VendorGuid
+  )
+{
+  UINT8         Buffer[VARIABLE_INDEX_HASH_BUFFER_SIZE];
+  CONST UINT8   *Bytes;
+  UINT32        Hash;
+  UINTN         Offset;
+  UINTN         Size;
+  UINTN         Index;
+
+  //
+  // FNV-1a hash of the vendor GUID followed by the name.
+  //
+  Hash  = 0x811C9DC5;
+  Bytes = (CONST UINT8 *) VendorGuid;
+  for (Index = 0; Index < sizeof (EFI_GUID); Index++) {
+    Hash = (Hash ^ Bytes[Index]) * 0x01000193;
+  }
+
+  for (Offset = 0; Offset < NameSize; Offset += Size) {
+    Size = MIN (NameSize - Offset, sizeof (Buffer));
+    if (StoreInfo != NULL) {
+      GetVariableNameOrData (StoreInfo, (UINT8 *) Name + Offset, Size, Buffer);
+      Bytes = Buffer;
+    } else {
+      Bytes = Name + Offset;
+    }
+    for (Index = 0; Index < Size; Index++) {
+      Hash = (Hash ^ Bytes[Index]) * 0x01000193;
+    }
+  }
+
+  return (UINT16) (Hash ^ (Hash >> 16));
+}
+
+/**
+  Record the VAR_ADDED type variables of the variable store in the variable index table.
+
+  Note that as the resource of PEI phase is limited, only the limited number of
+  VAR_ADDED type variables are recorded. GoneThrough is set if all the variables
+  of the variable store were recorded.
+
+  @param  StoreInfo     Pointer to the store info structure.
+
+**/
+VOID
+BuildVariableIndexTable (
+  IN VARIABLE_STORE_INFO    *StoreInfo
+  )
+{
+  VARIABLE_INDEX_TABLE    *IndexTable;
+  VARIABLE_STORE_HEADER   *VariableStoreHeader;
+  VARIABLE_HEADER         *Variable;
+  VARIABLE_HEADER         *LastVariable;
+  VARIABLE_HEADER         *VariableHeader;
+  UINTN                   Offset;
+
+  IndexTable          = StoreInfo->IndexTable;
+  VariableStoreHeader = StoreInfo->VariableStoreHeader;
+  if ((IndexTable == NULL) || (VariableStoreHeader == NULL) ||
+      (GetVariableStoreStatus (VariableStoreHeader) != EfiValid) ||
+      (~VariableStoreHeader->Size == 0)) {
+    return;
+  }
+
+  Variable     = IndexTable->StartPtr;
+  LastVariable = IndexTable->StartPtr;
+  while (GetVariableHeader (StoreInfo, Variable, &VariableHeader)) {
+    if (VariableHeader->State == VAR_ADDED || VariableHeader->State == (VAR_IN_DELETED_TRANSITION & VAR_ADDED)) {
+      Offset = (UINTN) Variable - (UINTN) LastVariable;
+      if ((Offset > 0x0FFFF) || (IndexTable->Length >= ARRAY_SIZE (IndexTable->Index))) {
+        //
+        // Stop to record if the distance of two neighbouring VAR_ADDED variable is larger than the allowable scope(UINT16),
+        // or the record buffer is full.
+        //
+        return;
+      }
+
+      IndexTable->Hash[IndexTable->Length] = GetVariableIndexHash (
+                                               StoreInfo,
+                                               (UINT8 *) GetVariableNamePtr (Variable, StoreInfo->AuthFlag),
+                                               NameSizeOfVariable (VariableHeader, StoreInfo->AuthFlag),
+                                               GetVendorGuidPtr (VariableHeader, StoreInfo->AuthFlag)
+                                               );
+      IndexTable->Index[IndexTable->Length++] = (UINT16) Offset;
+      LastVariable = Variable;
+    }
+
+    Variable = GetNextVariablePtr (StoreInfo, Variable, VariableHeader);
+  }
+
+  //
+  // All the variables of the variable store are recorded.
+  //
+  IndexTable->GoneThrough = 1;
+}
+
 /**
   Find the variable in the specified variable store.
 
@@ -805,15 +932,15 @@ FindVariableEx (
   )
 {
   VARIABLE_HEADER         *Variable;
-  VARIABLE_HEADER         *LastVariable;
   VARIABLE_HEADER         *MaxIndex;
   UINTN                   Index;
   UINTN                   Offset;
-  BOOLEAN                 StopRecord;
   VARIABLE_HEADER         *InDeletedVariable;
   VARIABLE_STORE_HEADER   *VariableStoreHeader;
   VARIABLE_INDEX_TABLE    *IndexTable;
   VARIABLE_HEADER         *VariableHeader;
+  BOOLEAN                 CompareHash;
+  UINT16                  Hash;
 
   VariableStoreHeader = StoreInfo->VariableStoreHeader;
 
@@ -842,6 +969,18 @@ FindVariableEx (
   VariableHeader = NULL;
 
   if (IndexTable != NULL) {
+    IndexTable->LookupCount++;
+
+    //
+    // The hash of the recorded variables can only be compared when looking for
+    // a named variable, an empty name matches the first variable.
+    //
+    CompareHash = (BOOLEAN) (VariableName[0] != 0);
+    Hash        = 0;
+    if (CompareHash) {
+      Hash = GetVariableIndexHash (NULL, (CONST UINT8 *) VariableName, StrSize (VariableName), VendorGuid);
+    }
+
     //
     // traverse the variable index table to look for varible.
     // The IndexTable->Index[Index] records the distance of two neighbouring VAR_ADDED type variables.
@@ -850,11 +989,15 @@ FindVariableEx (
       ASSERT (Index < sizeof (IndexTable->Index) / sizeof (IndexTable->Index[0]));
       Offset   += IndexTable->Index[Index];
       MaxIndex  = (VARIABLE_HEADER *) ((UINT8 *) IndexTable->StartPtr + Offset);
+      if (CompareHash && (IndexTable->Hash[Index] != Hash)) {
+        continue;
+      }
       GetVariableHeader (StoreInfo, MaxIndex, &VariableHeader);
       if (CompareWithValidVariable (StoreInfo, MaxIndex, VariableHeader, VariableName, VendorGuid, PtrTrack) == EFI_SUCCESS) {
         if (VariableHeader->State == (VAR_IN_DELETED_TRANSITION & VAR_ADDED)) {
           InDeletedVariable = PtrTrack->CurrPtr;
         } else {
+          IndexTable->IndexHitCount++;
           return EFI_SUCCESS;
         }
       }
@@ -864,9 +1007,12 @@ FindVariableEx (
       //
       // If the table has all the existing variables indexed, return.
       //
+      IndexTable->IndexHitCount++;
       PtrTrack->CurrPtr = InDeletedVariable;
       return (PtrTrack->CurrPtr == NULL) ? EFI_NOT_FOUND : EFI_SUCCESS;
     }
+
+    IndexTable->StoreWalkCount++;
   }
 
   if (MaxIndex != NULL) {
@@ -874,40 +1020,21 @@ FindVariableEx (
     // HOB exists but the variable cannot be found in HOB
     // If not found in HOB, then let's start from the MaxIndex we've found.
     //
-    Variable     = GetNextVariablePtr (StoreInfo, MaxIndex, VariableHeader);
-    LastVariable = MaxIndex;
+    GetVariableHeader (StoreInfo, MaxIndex, &VariableHeader);
+    Variable = GetNextVariablePtr (StoreInfo, MaxIndex, VariableHeader);
   } else {
     //
     // Start Pointers for the variable.
     // Actual Data Pointer where data can be written.
     //
-    Variable     = PtrTrack->StartPtr;
-    LastVariable = PtrTrack->StartPtr;
+    Variable = PtrTrack->StartPtr;
   }
 
   //
   // Find the variable by walk through variable store
   //
-  StopRecord = FALSE;
   while (GetVariableHeader (StoreInfo, Variable, &VariableHeader)) {
     if (VariableHeader->State == VAR_ADDED || VariableHeader->State == (VAR_IN_DELETED_TRANSITION & VAR_ADDED)) {
-      //
-      // Record Variable in VariableIndex HOB
-      //
-      if ((IndexTable != NULL) && !StopRecord) {
-        Offset = (UINTN) Variable - (UINTN) LastVariable;
-        if ((Offset > 0x0FFFF) || (IndexTable->Length >= sizeof (IndexTable->Index) / sizeof (IndexTable->Index[0]))) {
-          //
-          // Stop to record if the distance of two neighbouring VAR_ADDED variable is larger than the allowable scope(UINT16),
-          // or the record buffer is full.
-          //
-          StopRecord = TRUE;
-        } else {
-          IndexTable->Index[IndexTable->Length++] = (UINT16) Offset;
-          LastVariable = Variable;
-        }
-      }
-
       if (CompareWithValidVariable (StoreInfo, Variable, VariableHeader, VariableName, VendorGuid, PtrTrack) == EFI_SUCCESS) {
         if (VariableHeader->State == (VAR_IN_DELETED_TRANSITION & VAR_ADDED)) {
           InDeletedVariable = PtrTrack->CurrPtr;
@@ -919,12 +1046,6 @@ FindVariableEx (
 
     Variable = GetNextVariablePtr (StoreInfo, Variable, VariableHeader);
   }
-  //
-  // If gone through the VariableStore, that means we never find in Firmware any more.
-  //
-  if ((IndexTable != NULL) && !StopRecord) {
-    IndexTable->GoneThrough = 1;
-  }
 
   PtrTrack->CurrPtr = InDeletedVariable;
 
@@ -14,6 +14,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Ppi/ReadOnlyVariable2.h>
 
 #include <Library/DebugLib.h>
+#include <Library/BaseLib.h>
 #include <Library/PeimEntryPoint.h>
 #include <Library/HobLib.h>
 #include <Library/PcdLib.h>
@@ -26,6 +27,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/SystemNvDataGuid.h>
 #include <Guid/FaultTolerantWrite.h>
 
+//
+// Size of the buffer used to read a variable name from flash when it is hashed.
+//
+#define VARIABLE_INDEX_HASH_BUFFER_SIZE  64
+
 typedef enum {
   VariableStoreTypeHob,
   VariableStoreTypeNv,
@@ -47,6 +53,17 @@ typedef struct {
 //
 // Functions
 //
+/**
+  Record the VAR_ADDED type variables of the variable store in the variable index table.
+
+  @param  StoreInfo     Pointer to the store info structure.
+
+**/
+VOID
+BuildVariableIndexTable (
+  IN VARIABLE_STORE_INFO    *StoreInfo
+  );
+
 /**
   Provide the functionality of the variable services.
 
@@ -88,12 +88,14 @@ GetLbaAndOffsetByAddress (
 /**
   Writes a buffer to variable storage space, in the working block.
 
-  This function writes a buffer to variable storage space into a firmware
-  volume block device. The destination is specified by parameter
+  This function writes a range of a buffer to variable storage space into a
+  firmware volume block device. The destination is specified by parameter
   VariableBase. Fault Tolerant Write protocol is used for writing.
 
   @param  VariableBase   Base address of variable to write
   @param  VariableBuffer Point to the variable data buffer.
+  @param  Offset         Offset of the range to write from the start of the buffer.
+  @param  Length         Length in bytes of the range to write.
 
   @retval EFI_SUCCESS    The function completed successfully.
   @retval EFI_NOT_FOUND  Fail to locate Fault Tolerant Write protocol.
@@ -103,14 +105,15 @@ GetLbaAndOffsetByAddress (
 EFI_STATUS
 FtwVariableSpace (
   IN EFI_PHYSICAL_ADDRESS   VariableBase,
-  IN VARIABLE_STORE_HEADER  *VariableBuffer
+  IN VARIABLE_STORE_HEADER  *VariableBuffer,
+  IN UINTN                  Offset,
+  IN UINTN                  Length
   )
 {
   EFI_STATUS                         Status;
   EFI_HANDLE                         FvbHandle;
   EFI_LBA                            VarLba;
   UINTN                              VarOffset;
-  UINTN                              FtwBufferSize;
   EFI_FAULT_TOLERANT_WRITE_PROTOCOL  *FtwProtocol;
 
   //
@@ -130,13 +133,13 @@ FtwVariableSpace (
   //
   // Get LBA and Offset by address.
   //
-  Status = GetLbaAndOffsetByAddress (VariableBase, &VarLba, &VarOffset);
+  Status = GetLbaAndOffsetByAddress (VariableBase + Offset, &VarLba, &VarOffset);
   if (EFI_ERROR (Status)) {
     return EFI_ABORTED;
   }
 
-  FtwBufferSize = ((VARIABLE_STORE_HEADER *) ((UINTN) VariableBase))->Size;
-  ASSERT (FtwBufferSize == VariableBuffer->Size);
+  ASSERT (((VARIABLE_STORE_HEADER *) ((UINTN) VariableBase))->Size == VariableBuffer->Size);
+  ASSERT (Offset + Length <= VariableBuffer->Size);
 
   //
   // FTW write record.
@@ -145,11 +148,109 @@ FtwVariableSpace (
                           FtwProtocol,
                           VarLba,         // LBA
                           VarOffset,      // Offset
-                          FtwBufferSize,  // NumBytes
+                          Length,         // NumBytes
                           NULL,           // PrivateData NULL
                           FvbHandle,      // Fvb Handle
-                          (VOID *) VariableBuffer // write buffer
+                          (UINT8 *) VariableBuffer + Offset // write buffer
                           );
 
   return Status;
 }
+
+/**
+  Gets the range of a variable store buffer that differs from the store.
+
+  Reclaim keeps the variables in front of the first deleted one in place, so
+  only the range from there to the old end of the store has to be written.
+
+  @param  VariableBase   Base address of the variable store.
+  @param  VariableBuffer Point to the new content of the variable store.
+  @param  Offset         Pointer to the offset of the first different byte for output.
+  @param  Length         Pointer to the length of the different range for output,
+                         0 if the buffer is identical to the store.
+
+**/
+VOID
+GetVariableSpaceChangedRange (
+  IN  EFI_PHYSICAL_ADDRESS   VariableBase,
+  IN  VARIABLE_STORE_HEADER  *VariableBuffer,
+  OUT UINTN                  *Offset,
+  OUT UINTN                  *Length
+  )
+{
+  UINT8                      *Store;
+  UINT8                      *Buffer;
+  UINTN                      Start;
+  UINTN                      End;
+
+  Store  = (UINT8 *) (UINTN) VariableBase;
+  Buffer = (UINT8 *) VariableBuffer;
+
+  for (Start = 0; Start < VariableBuffer->Size; Start++) {
+    if (Store[Start] != Buffer[Start]) {
+      break;
+    }
+  }
+
+  for (End = VariableBuffer->Size; End > Start; End--) {
+    if (Store[End - 1] != Buffer[End - 1]) {
+      break;
+    }
+  }
+
+  *Offset = Start;
+  *Length = End - Start;
+}
+
+/**
+  Records a reclaim of the non-volatile variable store in the statistics.
+
+  The time of the reclaim is only measured if PcdVariableCollectStatistics is
+  TRUE and the performance counter reports a frequency.
+
+  @param  BytesWritten   Number of bytes written to flash by the reclaim.
+  @param  StartTicks     Performance counter when the reclaim started.
+
+**/
+VOID
+RecordVariableReclaim (
+  IN UINTN   BytesWritten,
+  IN UINT64  StartTicks
+  )
+{
+  VARIABLE_RECLAIM_STATISTICS        *Statistics;
+  UINT64                             EndTicks;
+  UINT64                             CounterStart;
+  UINT64                             CounterEnd;
+  UINT64                             Time;
+
+  Time = 0;
+  if (FeaturePcdGet (PcdVariableCollectStatistics)) {
+    EndTicks = GetPerformanceCounter ();
+    if (GetPerformanceCounterProperties (&CounterStart, &CounterEnd) != 0) {
+      if (CounterEnd >= CounterStart) {
+        Time = GetTimeInNanoSecond (EndTicks - StartTicks);
+      } else {
+        Time = GetTimeInNanoSecond (StartTicks - EndTicks);
+      }
+    }
+  }
+
+  Statistics = &mVariableModuleGlobal->ReclaimStatistics;
+  Statistics->ReclaimCount++;
+  Statistics->BytesWritten += BytesWritten;
+  Statistics->TotalTime    += Time;
+  if (Time > Statistics->MaxTime) {
+    Statistics->MaxTime = Time;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "Variable: Reclaim %d wrote 0x%lx bytes in %ld ns (total 0x%lx bytes, %ld ns)\n",
+    Statistics->ReclaimCount,
+    (UINT64) BytesWritten,
+    Time,
+    Statistics->BytesWritten,
+    Statistics->TotalTime
+    ));
+}
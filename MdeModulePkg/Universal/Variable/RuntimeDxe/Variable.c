@@ -26,6 +26,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "VariableNonVolatile.h"
 #include "VariableParsing.h"
 #include "VariableRuntimeCache.h"
+#include "VariableIndex.h"
 
 VARIABLE_MODULE_GLOBAL  *mVariableModuleGlobal;
 
@@ -164,6 +165,19 @@ UpdateVariableStore (
     if ((DataPtr + DataSize) > (FvVolHdr + mNvFvHeaderCache->FvLength)) {
       return EFI_OUT_OF_RESOURCES;
     }
+
+    if (mVariableModuleGlobal->BatchInProgress) {
+      //
+      // A batch of updates is in progress, only update the memory copy of the
+      // variable store. The batch is written to flash when it is complete.
+      //
+      if ((DataPtr < Global->NonVolatileVariableBase) ||
+          ((DataPtr + DataSize) > (Global->NonVolatileVariableBase + mNvVariableCache->Size))) {
+        return EFI_INVALID_PARAMETER;
+      }
+      CopyMem ((UINT8 *) mNvVariableCache + (UINTN) (DataPtr - Global->NonVolatileVariableBase), Buffer, DataSize);
+      return EFI_SUCCESS;
+    }
   } else {
     //
     // Data Pointer should point to the actual Address where data is to be
@@ -488,6 +502,97 @@ InitializeVariableQuota (
   CalculateCommonUserVariableTotalSize ();
 }
 
+/**
+  Write the pending non-volatile variable updates of a batch to flash.
+
+  The updates are only in the memory copy of the variable store, the range of
+  it that differs from flash is written in one Fault Tolerant Write transaction.
+
+  @retval EFI_SUCCESS            The updates were written, or there was none.
+  @return Others                 The Fault Tolerant Write failed.
+
+**/
+EFI_STATUS
+WriteVariableBatch (
+  VOID
+  )
+{
+  EFI_PHYSICAL_ADDRESS  VariableBase;
+  UINTN                 ChangedOffset;
+  UINTN                 ChangedLength;
+
+  if (mVariableModuleGlobal->VariableGlobal.EmuNvMode) {
+    return EFI_SUCCESS;
+  }
+
+  VariableBase = mVariableModuleGlobal->VariableGlobal.NonVolatileVariableBase;
+  GetVariableSpaceChangedRange (VariableBase, mNvVariableCache, &ChangedOffset, &ChangedLength);
+  if (ChangedLength == 0) {
+    return EFI_SUCCESS;
+  }
+
+  return FtwVariableSpace (VariableBase, mNvVariableCache, ChangedOffset, ChangedLength);
+}
+
+/**
+  Discard the pending non-volatile variable updates of a batch.
+
+  The memory copy of the variable store is reloaded from flash, and the sizes
+  and the lookup index derived from it are recalculated.
+
+**/
+VOID
+DiscardVariableBatch (
+  VOID
+  )
+{
+  EFI_STATUS            Status;
+  VARIABLE_HEADER       *Variable;
+  VARIABLE_HEADER       *NextVariable;
+  UINTN                 VariableSize;
+  BOOLEAN               AuthFormat;
+
+  if (mVariableModuleGlobal->VariableGlobal.EmuNvMode) {
+    return;
+  }
+
+  AuthFormat = mVariableModuleGlobal->VariableGlobal.AuthFormat;
+  CopyMem (
+    mNvVariableCache,
+    (VOID *) (UINTN) mVariableModuleGlobal->VariableGlobal.NonVolatileVariableBase,
+    mNvVariableCache->Size
+    );
+
+  mVariableModuleGlobal->HwErrVariableTotalSize = 0;
+  mVariableModuleGlobal->CommonVariableTotalSize = 0;
+  mVariableModuleGlobal->CommonUserVariableTotalSize = 0;
+  Variable = GetStartPointer (mNvVariableCache);
+  while (IsValidVariableHeader (Variable, GetEndPointer (mNvVariableCache))) {
+    NextVariable = GetNextVariablePtr (Variable, AuthFormat);
+    VariableSize = (UINTN) NextVariable - (UINTN) Variable;
+    if ((Variable->Attributes & EFI_VARIABLE_HARDWARE_ERROR_RECORD) == EFI_VARIABLE_HARDWARE_ERROR_RECORD) {
+      mVariableModuleGlobal->HwErrVariableTotalSize += VariableSize;
+    } else {
+      mVariableModuleGlobal->CommonVariableTotalSize += VariableSize;
+      if (IsUserVariable (Variable)) {
+        mVariableModuleGlobal->CommonUserVariableTotalSize += VariableSize;
+      }
+    }
+
+    Variable = NextVariable;
+  }
+  mVariableModuleGlobal->NonVolatileLastVariableOffset = (UINTN) Variable - (UINTN) mNvVariableCache;
+
+  RebuildVariableStoreIndex (&mVariableModuleGlobal->NvVariableIndex, mNvVariableCache, AuthFormat);
+
+  Status =  SynchronizeRuntimeVariableCache (
+              &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeNvCache,
+              0,
+              mNvVariableCache->Size
+              );
+  ASSERT_EFI_ERROR (Status);
+}
+
 /**
 
   Variable store garbage collection and reclaim operation.
@@ -535,7 +640,11 @@ Reclaim (
   VARIABLE_HEADER       *UpdatingVariable;
   VARIABLE_HEADER       *UpdatingInDeletedTransition;
   BOOLEAN               AuthFormat;
+  UINT64                StartTicks;
+  UINTN                 ChangedOffset;
+  UINTN                 ChangedLength;
 
+  StartTicks = 0;
   AuthFormat = mVariableModuleGlobal->VariableGlobal.AuthFormat;
   UpdatingVariable = NULL;
   UpdatingInDeletedTransition = NULL;
@@ -587,6 +696,20 @@ Reclaim (
       return EFI_OUT_OF_RESOURCES;
     }
   } else {
+    if (FeaturePcdGet (PcdVariableCollectStatistics)) {
+      StartTicks = GetPerformanceCounter ();
+    }
+
+    if (mVariableModuleGlobal->BatchInProgress) {
+      //
+      // The updates of a batch in progress are only in mNvVariableCache, and
+      // the store is compacted from flash below. Writing them first would
+      // break the batch, so fail the update and let the batch be discarded.
+      // The batch reclaims up front when its updates do not fit.
+      //
+      return EFI_OUT_OF_RESOURCES;
+    }
+
     //
     // For NV variable reclaim, don't allocate pool here and just use mNvVariableCache
     // as the buffer to reduce SMRAM consumption for SMM variable driver.
@@ -737,13 +860,28 @@ Reclaim (
     Status  = EFI_SUCCESS;
   } else {
     //
-    // If non-volatile variable store, perform FTW here.
+    // If non-volatile variable store, perform FTW here. Only the range changed
+    // by the reclaim is written, so the blocks holding the variables in front
+    // of the first deleted one are not erased and programmed again.
     //
-    Status = FtwVariableSpace (
-              VariableBase,
-              (VARIABLE_STORE_HEADER *) ValidBuffer
-              );
+    GetVariableSpaceChangedRange (
+      VariableBase,
+      (VARIABLE_STORE_HEADER *) ValidBuffer,
+      &ChangedOffset,
+      &ChangedLength
+      );
+    if (ChangedLength == 0) {
+      Status = EFI_SUCCESS;
+    } else {
+      Status = FtwVariableSpace (
+                VariableBase,
+                (VARIABLE_STORE_HEADER *) ValidBuffer,
+                ChangedOffset,
+                ChangedLength
+                );
+    }
     if (!EFI_ERROR (Status)) {
+      RecordVariableReclaim (ChangedLength, StartTicks);
       *LastVariableOffset = (UINTN) CurrPtr - (UINTN) ValidBuffer;
       mVariableModuleGlobal->HwErrVariableTotalSize = HwErrVariableTotalSize;
       mVariableModuleGlobal->CommonVariableTotalSize = CommonVariableTotalSize;
@@ -793,6 +931,23 @@ Done:
     ASSERT_EFI_ERROR (Status);
   }
 
+  //
+  // The variables have been moved, rebuild the lookup index of the store.
+  //
+  if (IsVolatile) {
+    RebuildVariableStoreIndex (
+      &mVariableModuleGlobal->VolatileVariableIndex,
+      (VARIABLE_STORE_HEADER *) (UINTN) VariableBase,
+      AuthFormat
+      );
+  } else {
+    RebuildVariableStoreIndex (
+      &mVariableModuleGlobal->NvVariableIndex,
+      mNvVariableCache,
+      AuthFormat
+      );
+  }
+
   return Status;
 }
 
@@ -833,6 +988,7 @@ FindVariable (
 {
   EFI_STATUS              Status;
   VARIABLE_STORE_HEADER   *VariableStoreHeader[VariableStoreTypeMax];
+  VARIABLE_STORE_INDEX    *VariableIndex[VariableStoreTypeMax];
   VARIABLE_STORE_TYPE     Type;
 
   if (VariableName[0] != 0 && VendorGuid == NULL) {
@@ -848,6 +1004,13 @@ FindVariable (
   VariableStoreHeader[VariableStoreTypeHob]      = (VARIABLE_STORE_HEADER *) (UINTN) Global->HobVariableBase;
   VariableStoreHeader[VariableStoreTypeNv]       = mNvVariableCache;
 
+  //
+  // The HOB variable store is not indexed.
+  //
+  VariableIndex[VariableStoreTypeVolatile] = &mVariableModuleGlobal->VolatileVariableIndex;
+  VariableIndex[VariableStoreTypeHob]      = NULL;
+  VariableIndex[VariableStoreTypeNv]       = &mVariableModuleGlobal->NvVariableIndex;
+
   //
   // Find the variable by walk through HOB, volatile and non-volatile variable store.
   //
@@ -860,13 +1023,26 @@ FindVariable (
     PtrTrack->EndPtr   = GetEndPointer   (VariableStoreHeader[Type]);
     PtrTrack->Volatile = (BOOLEAN) (Type == VariableStoreTypeVolatile);
 
-    Status =  FindVariableEx (
-                VariableName,
-                VendorGuid,
-                IgnoreRtCheck,
-                PtrTrack,
-                mVariableModuleGlobal->VariableGlobal.AuthFormat
-                );
+    Status = EFI_UNSUPPORTED;
+    if (VariableIndex[Type] != NULL) {
+      Status = FindVariableInStoreIndex (
+                 VariableIndex[Type],
+                 VariableName,
+                 VendorGuid,
+                 IgnoreRtCheck,
+                 PtrTrack,
+                 mVariableModuleGlobal->VariableGlobal.AuthFormat
+                 );
+    }
+    if (Status == EFI_UNSUPPORTED) {
+      Status =  FindVariableEx (
+                  VariableName,
+                  VendorGuid,
+                  IgnoreRtCheck,
+                  PtrTrack,
+                  mVariableModuleGlobal->VariableGlobal.AuthFormat
+                  );
+    }
     if (!EFI_ERROR (Status)) {
       return Status;
     }
@@ -2180,6 +2356,12 @@ UpdateVariable (
       }
     }
 
+    AddVariableToStoreIndex (
+      &mVariableModuleGlobal->NvVariableIndex,
+      mNvVariableCache,
+      mVariableModuleGlobal->NonVolatileLastVariableOffset,
+      AuthFormat
+      );
     mVariableModuleGlobal->NonVolatileLastVariableOffset += HEADER_ALIGN (VarSize);
 
     if ((Attributes & EFI_VARIABLE_HARDWARE_ERROR_RECORD) != 0) {
@@ -2237,6 +2419,12 @@ UpdateVariable (
       goto Done;
     }
 
+    AddVariableToStoreIndex (
+      &mVariableModuleGlobal->VolatileVariableIndex,
+      (VARIABLE_STORE_HEADER *) (UINTN) mVariableModuleGlobal->VariableGlobal.VolatileVariableBase,
+      mVariableModuleGlobal->VolatileLastVariableOffset,
+      AuthFormat
+      );
     mVariableModuleGlobal->VolatileLastVariableOffset += HEADER_ALIGN (VarSize);
   }
 
@@ -2720,13 +2908,25 @@ VariableServiceSetVariable (
     return Status;
   }
 
-  AcquireLockOnlyAtBootTime(&mVariableModuleGlobal->VariableGlobal.VariableServicesLock);
+  //
+  // A batch in progress already holds the lock while it applies its updates.
+  //
+  if (!mVariableModuleGlobal->BatchInProgress) {
+    AcquireLockOnlyAtBootTime(&mVariableModuleGlobal->VariableGlobal.VariableServicesLock);
+  }
 
   //
   // Consider reentrant in MCA/INIT/NMI. It needs be reupdated.
   //
   if (1 < InterlockedIncrement (&mVariableModuleGlobal->VariableGlobal.ReentrantState)) {
-    Point = mVariableModuleGlobal->VariableGlobal.NonVolatileVariableBase;
+    //
+    // The updates of a batch in progress are only in mNvVariableCache.
+    //
+    if (mVariableModuleGlobal->BatchInProgress) {
+      Point = (EFI_PHYSICAL_ADDRESS) (UINTN) mNvVariableCache;
+    } else {
+      Point = mVariableModuleGlobal->VariableGlobal.NonVolatileVariableBase;
+    }
     //
     // Parse non-volatile variable data and get last variable offset.
     //
@@ -2735,6 +2935,7 @@ VariableServiceSetVariable (
       NextVariable = GetNextVariablePtr (NextVariable, AuthFormat);
     }
     mVariableModuleGlobal->NonVolatileLastVariableOffset = (UINTN) NextVariable - (UINTN) Point;
+    RebuildVariableStoreIndex (&mVariableModuleGlobal->NvVariableIndex, mNvVariableCache, AuthFormat);
   }
 
   //
@@ -2780,7 +2981,9 @@ VariableServiceSetVariable (
 
 Done:
   InterlockedDecrement (&mVariableModuleGlobal->VariableGlobal.ReentrantState);
-  ReleaseLockOnlyAtBootTime (&mVariableModuleGlobal->VariableGlobal.VariableServicesLock);
+  if (!mVariableModuleGlobal->BatchInProgress) {
+    ReleaseLockOnlyAtBootTime (&mVariableModuleGlobal->VariableGlobal.VariableServicesLock);
+  }
 
   if (!AtRuntime ()) {
     if (!EFI_ERROR (Status)) {
@@ -3648,6 +3851,22 @@ VariableCommonInitialize (
   VolatileVariableStore->Reserved    = 0;
   VolatileVariableStore->Reserved1   = 0;
 
+  //
+  // Build the lookup index of the volatile and non-volatile variable stores.
+  //
+  if (FeaturePcdGet (PcdEnableVariableStoreIndex)) {
+    InitVariableStoreIndex (
+      &mVariableModuleGlobal->VolatileVariableIndex,
+      VolatileVariableStore,
+      mVariableModuleGlobal->VariableGlobal.AuthFormat
+      );
+    InitVariableStoreIndex (
+      &mVariableModuleGlobal->NvVariableIndex,
+      mNvVariableCache,
+      mVariableModuleGlobal->VariableGlobal.AuthFormat
+      );
+  }
+
   return EFI_SUCCESS;
 }
 
@@ -16,6 +16,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/FirmwareVolumeBlock.h>
 #include <Protocol/Variable.h>
 #include <Protocol/VariableLock.h>
+#include <Protocol/VariableBatch.h>
 #include <Protocol/VarCheck.h>
 #include <Library/PcdLib.h>
 #include <Library/HobLib.h>
@@ -29,6 +30,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/BaseLib.h>
 #include <Library/SynchronizationLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
 #include <Library/AuthVariableLib.h>
 #include <Library/VarCheckLib.h>
 #include <Guid/GlobalVariable.h>
@@ -37,6 +39,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/SystemNvDataGuid.h>
 #include <Guid/FaultTolerantWrite.h>
 #include <Guid/VarErrorFlag.h>
+#include <Guid/VariableReclaimStatistics.h>
 
 #include "PrivilegePolymorphic.h"
 
@@ -93,6 +96,37 @@ typedef struct {
   BOOLEAN         Volatile;
 } VARIABLE_POINTER_TRACK;
 
+///
+/// Number of hash buckets in the lookup index of a variable store, must be a power of 2.
+///
+#define VARIABLE_INDEX_BUCKET_COUNT  256
+
+typedef struct {
+  //
+  // Offset of the variable header from the start pointer of the variable store.
+  //
+  UINT32                  Offset;
+  //
+  // Number of the next entry in the same hash bucket plus 1, or 0 at the end of the chain.
+  //
+  UINT32                  Next;
+} VARIABLE_INDEX_ENTRY;
+
+typedef struct {
+  //
+  // Number of the first entry of each hash bucket plus 1, or 0 for an empty bucket.
+  // NULL if the variable store is not indexed.
+  //
+  UINT32                  *Buckets;
+  //
+  // Pointer to the buffer with the MaxEntryCount number of entries.
+  //
+  VARIABLE_INDEX_ENTRY    *Entries;
+  UINT32                  EntryCount;
+  UINT32                  MaxEntryCount;
+  BOOLEAN                 Valid;
+} VARIABLE_STORE_INDEX;
+
 typedef struct {
   EFI_PHYSICAL_ADDRESS            HobVariableBase;
   EFI_PHYSICAL_ADDRESS            VolatileVariableBase;
@@ -124,6 +158,15 @@ typedef struct {
   CHAR8           *PlatformLang;
   CHAR8           Lang[ISO_639_2_ENTRY_SIZE + 1];
   EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL *FvbInstance;
+  VARIABLE_STORE_INDEX  VolatileVariableIndex;
+  VARIABLE_STORE_INDEX  NvVariableIndex;
+  VARIABLE_RECLAIM_STATISTICS ReclaimStatistics;
+  //
+  // TRUE while EDKII_VARIABLE_BATCH_PROTOCOL.SetVariables () applies its updates
+  // with the variable services lock held, the non-volatile updates are then only
+  // applied to mNvVariableCache.
+  //
+  BOOLEAN         BatchInProgress;
 } VARIABLE_MODULE_GLOBAL;
 
 /**
@@ -142,12 +185,14 @@ FlushHobVariableToFlash (
 /**
   Writes a buffer to variable storage space, in the working block.
 
-  This function writes a buffer to variable storage space into a firmware
-  volume block device. The destination is specified by the parameter
+  This function writes a range of a buffer to variable storage space into a
+  firmware volume block device. The destination is specified by the parameter
   VariableBase. Fault Tolerant Write protocol is used for writing.
 
   @param  VariableBase   Base address of the variable to write.
   @param  VariableBuffer Point to the variable data buffer.
+  @param  Offset         Offset of the range to write from the start of the buffer.
+  @param  Length         Length in bytes of the range to write.
 
   @retval EFI_SUCCESS    The function completed successfully.
   @retval EFI_NOT_FOUND  Fail to locate Fault Tolerant Write protocol.
@@ -157,7 +202,43 @@ FlushHobVariableToFlash (
 EFI_STATUS
 FtwVariableSpace (
   IN EFI_PHYSICAL_ADDRESS   VariableBase,
-  IN VARIABLE_STORE_HEADER  *VariableBuffer
+  IN VARIABLE_STORE_HEADER  *VariableBuffer,
+  IN UINTN                  Offset,
+  IN UINTN                  Length
+  );
+
+/**
+  Gets the range of a variable store buffer that differs from the store.
+
+  @param  VariableBase   Base address of the variable store.
+  @param  VariableBuffer Point to the new content of the variable store.
+  @param  Offset         Pointer to the offset of the first different byte for output.
+  @param  Length         Pointer to the length of the different range for output,
+                         0 if the buffer is identical to the store.
+
+**/
+VOID
+GetVariableSpaceChangedRange (
+  IN  EFI_PHYSICAL_ADDRESS   VariableBase,
+  IN  VARIABLE_STORE_HEADER  *VariableBuffer,
+  OUT UINTN                  *Offset,
+  OUT UINTN                  *Length
+  );
+
+/**
+  Records a reclaim of the non-volatile variable store in the statistics.
+
+  The time of the reclaim is only measured if PcdVariableCollectStatistics is
+  TRUE and the performance counter reports a frequency.
+
+  @param  BytesWritten   Number of bytes written to flash by the reclaim.
+  @param  StartTicks     Performance counter when the reclaim started.
+
+**/
+VOID
+RecordVariableReclaim (
+  IN UINTN   BytesWritten,
+  IN UINT64  StartTicks
   );
 
 /**
@@ -617,6 +698,86 @@ VariableLockRequestToLock (
   IN       EFI_GUID                     *VendorGuid
   );
 
+/**
+
+  Variable store garbage collection and reclaim operation.
+
+  @param[in]      VariableBase            Base address of variable store.
+  @param[out]     LastVariableOffset      Offset of last variable.
+  @param[in]      IsVolatile              The variable store is volatile or not;
+                                          if it is non-volatile, need FTW.
+  @param[in, out] UpdatingPtrTrack        Pointer to updating variable pointer track structure.
+  @param[in]      NewVariable             Pointer to new variable.
+  @param[in]      NewVariableSize         New variable size.
+
+  @return EFI_SUCCESS                  Reclaim operation has finished successfully.
+  @return EFI_OUT_OF_RESOURCES         No enough memory resources or variable space.
+  @return Others                       Unexpect error happened during reclaim operation.
+
+**/
+EFI_STATUS
+Reclaim (
+  IN     EFI_PHYSICAL_ADDRESS         VariableBase,
+  OUT    UINTN                        *LastVariableOffset,
+  IN     BOOLEAN                      IsVolatile,
+  IN OUT VARIABLE_POINTER_TRACK       *UpdatingPtrTrack,
+  IN     VARIABLE_HEADER              *NewVariable,
+  IN     UINTN                        NewVariableSize
+  );
+
+/**
+  Write the pending non-volatile variable updates of a batch to flash.
+
+  The updates are only in the memory copy of the variable store, the range of
+  it that differs from flash is written in one Fault Tolerant Write transaction.
+
+  @retval EFI_SUCCESS            The updates were written, or there was none.
+  @return Others                 The Fault Tolerant Write failed.
+
+**/
+EFI_STATUS
+WriteVariableBatch (
+  VOID
+  );
+
+/**
+  Discard the pending non-volatile variable updates of a batch.
+
+  The memory copy of the variable store is reloaded from flash, and the sizes
+  and the lookup index derived from it are recalculated.
+
+**/
+VOID
+DiscardVariableBatch (
+  VOID
+  );
+
+/**
+  Apply a list of variable updates and write them to flash together.
+
+  @param[in] This          The EDKII_VARIABLE_BATCH_PROTOCOL instance.
+  @param[in] UpdateCount   The number of entries in Updates.
+  @param[in] Updates       The variable updates to apply.
+
+  @retval EFI_SUCCESS           All the updates were written.
+  @retval EFI_INVALID_PARAMETER An update is invalid or not allowed in a batch.
+  @retval EFI_OUT_OF_RESOURCES  The updates do not fit in the variable store.
+  @retval EFI_UNSUPPORTED       The variable write service is not ready yet, the
+                                function is called at OS runtime, or it is called
+                                above TPL_CALLBACK. Or the batch could not be rolled
+                                back: the variables are emulated in memory, or some
+                                variables of the variable HOB are not flushed yet.
+  @retval Others                An update failed with this status, or the batch
+                                could not be written.
+**/
+EFI_STATUS
+EFIAPI
+VariableBatchSetVariables (
+  IN CONST EDKII_VARIABLE_BATCH_PROTOCOL  *This,
+  IN       UINTN                          UpdateCount,
+  IN       EDKII_VARIABLE_BATCH_UPDATE    *Updates
+  );
+
 /**
   Register SetVariable check handler.
 
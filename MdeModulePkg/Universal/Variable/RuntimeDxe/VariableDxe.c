@@ -17,6 +17,7 @@ VOID                                *mFtwRegistration          = NULL;
 VOID                                ***mVarCheckAddressPointer = NULL;
 UINTN                               mVarCheckAddressPointerCount = 0;
 EDKII_VARIABLE_LOCK_PROTOCOL        mVariableLock              = { VariableLockRequestToLock };
+EDKII_VARIABLE_BATCH_PROTOCOL       mVariableBatch             = { VariableBatchSetVariables };
 EDKII_VAR_CHECK_PROTOCOL            mVarCheck                  = { VarCheckRegisterSetVariableCheckHandler,
                                                                     VarCheckVariablePropertySet,
                                                                     VarCheckVariablePropertyGet };
@@ -211,6 +212,178 @@ GetFvbCountAndBuffer (
 }
 
 
+/**
+  Apply a list of variable updates and write them to flash together.
+
+  Every update is checked before any of them is applied. The variable services
+  lock is then held while the updates are applied to the memory copy of the
+  variable store, so the variable updates of other callers cannot run in between
+  and end up in the batch. If an update fails or the batch cannot be written,
+  the memory copy is reloaded from flash and none of the updates is written.
+
+  @param[in] This          The EDKII_VARIABLE_BATCH_PROTOCOL instance.
+  @param[in] UpdateCount   The number of entries in Updates.
+  @param[in] Updates       The variable updates to apply.
+
+  @retval EFI_SUCCESS           All the updates were written.
+  @retval EFI_INVALID_PARAMETER An update is invalid or not allowed in a batch.
+  @retval EFI_OUT_OF_RESOURCES  The updates do not fit in the variable store.
+  @retval EFI_UNSUPPORTED       The variable write service is not ready yet, the
+                                function is called at OS runtime, or it is called
+                                above TPL_CALLBACK. Or the batch could not be rolled
+                                back: the variables are emulated in memory, or some
+                                variables of the variable HOB are not flushed yet.
+  @retval Others                An update failed with this status, or the batch
+                                could not be written.
+**/
+EFI_STATUS
+EFIAPI
+VariableBatchSetVariables (
+  IN CONST EDKII_VARIABLE_BATCH_PROTOCOL  *This,
+  IN       UINTN                          UpdateCount,
+  IN       EDKII_VARIABLE_BATCH_UPDATE    *Updates
+  )
+{
+  EFI_STATUS                  Status;
+  EFI_TPL                     OldTpl;
+  UINTN                       Index;
+  UINTN                       NameSize;
+  UINTN                       HeaderSize;
+  UINTN                       RequiredSize;
+  EDKII_VARIABLE_BATCH_UPDATE *Update;
+
+  if (UpdateCount == 0) {
+    return EFI_SUCCESS;
+  }
+  if (Updates == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+  //
+  // A failed batch is rolled back by reloading the memory copy of the store from
+  // flash. There is no flash copy in emulated non-volatile variable mode, and
+  // the variables still in the variable HOB are marked deleted there in memory
+  // when they are flushed, so neither case can be rolled back.
+  //
+  if (AtRuntime () ||
+      mVariableModuleGlobal->VariableGlobal.EmuNvMode ||
+      (mVariableModuleGlobal->FvbInstance == NULL) ||
+      (mVariableModuleGlobal->VariableGlobal.HobVariableBase != 0)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // SetVariable () may not be called above TPL_CALLBACK.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  gBS->RestoreTPL (OldTpl);
+  if (OldTpl > TPL_CALLBACK) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Only non-volatile updates are rolled back with the memory copy of the store.
+  // The in-memory state of AuthVariableLib follows the authenticated variable
+  // updates and cannot be rolled back, so authenticated variables are refused,
+  // and so is appended data whose final size is not known here. The language
+  // variables are refused as well, SetVariable () keeps the current languages in
+  // memory and updates the other language variable along with them.
+  //
+  HeaderSize   = GetVariableHeaderSize (mVariableModuleGlobal->VariableGlobal.AuthFormat);
+  RequiredSize = 0;
+  for (Index = 0; Index < UpdateCount; Index++) {
+    Update = &Updates[Index];
+    if ((Update->VariableName == NULL) || (Update->VariableName[0] == 0) || (Update->VendorGuid == NULL) ||
+        ((Update->DataSize != 0) && (Update->Data == NULL))) {
+      return EFI_INVALID_PARAMETER;
+    }
+    if ((StrCmp (Update->VariableName, EFI_PLATFORM_LANG_CODES_VARIABLE_NAME) == 0) ||
+        (StrCmp (Update->VariableName, EFI_LANG_CODES_VARIABLE_NAME) == 0) ||
+        (StrCmp (Update->VariableName, EFI_PLATFORM_LANG_VARIABLE_NAME) == 0) ||
+        (StrCmp (Update->VariableName, EFI_LANG_VARIABLE_NAME) == 0)) {
+      return EFI_INVALID_PARAMETER;
+    }
+    if (((Update->Attributes & EFI_VARIABLE_NON_VOLATILE) == 0) ||
+        ((Update->Attributes & (EFI_VARIABLE_AUTHENTICATED_WRITE_ACCESS |
+                                EFI_VARIABLE_TIME_BASED_AUTHENTICATED_WRITE_ACCESS |
+                                EFI_VARIABLE_HARDWARE_ERROR_RECORD |
+                                EFI_VARIABLE_APPEND_WRITE)) != 0)) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    NameSize = StrSize (Update->VariableName);
+    if ((Update->DataSize > mVariableModuleGlobal->MaxVariableSize) ||
+        (NameSize + Update->DataSize > mVariableModuleGlobal->MaxVariableSize - HeaderSize)) {
+      return EFI_INVALID_PARAMETER;
+    }
+    if (Update->DataSize != 0) {
+      RequiredSize += HEADER_ALIGN (HeaderSize + NameSize + GET_PAD_SIZE (NameSize) +
+                                    Update->DataSize + GET_PAD_SIZE (Update->DataSize));
+    }
+  }
+
+  AcquireLockOnlyAtBootTime (&mVariableModuleGlobal->VariableGlobal.VariableServicesLock);
+
+  //
+  // A reclaim cannot run while the updates are applied, as it compacts the store
+  // from flash. Reclaim first if the updates do not fit behind the last variable.
+  //
+  if ((mVariableModuleGlobal->NonVolatileLastVariableOffset + RequiredSize > mNvVariableCache->Size) ||
+      (mVariableModuleGlobal->CommonVariableTotalSize + RequiredSize > mVariableModuleGlobal->CommonVariableSpace)) {
+    Status = Reclaim (
+               mVariableModuleGlobal->VariableGlobal.NonVolatileVariableBase,
+               &mVariableModuleGlobal->NonVolatileLastVariableOffset,
+               FALSE,
+               NULL,
+               NULL,
+               0
+               );
+    if (!EFI_ERROR (Status) &&
+        ((mVariableModuleGlobal->NonVolatileLastVariableOffset + RequiredSize > mNvVariableCache->Size) ||
+         (mVariableModuleGlobal->CommonVariableTotalSize + RequiredSize > mVariableModuleGlobal->CommonVariableSpace))) {
+      Status = EFI_OUT_OF_RESOURCES;
+    }
+    if (EFI_ERROR (Status)) {
+      ReleaseLockOnlyAtBootTime (&mVariableModuleGlobal->VariableGlobal.VariableServicesLock);
+      return Status;
+    }
+  }
+
+  //
+  // VariableServiceSetVariable () does not take the lock again while the batch
+  // holds it.
+  //
+  Status = EFI_SUCCESS;
+  mVariableModuleGlobal->BatchInProgress = TRUE;
+  for (Index = 0; Index < UpdateCount; Index++) {
+    Update = &Updates[Index];
+    Status = VariableServiceSetVariable (
+               Update->VariableName,
+               Update->VendorGuid,
+               Update->Attributes,
+               Update->DataSize,
+               Update->Data
+               );
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+  mVariableModuleGlobal->BatchInProgress = FALSE;
+
+  if (!EFI_ERROR (Status)) {
+    Status = WriteVariableBatch ();
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "Variable: Failed to write the batch of variable updates - %r\n", Status));
+    }
+  }
+  if (EFI_ERROR (Status)) {
+    DiscardVariableBatch ();
+  }
+
+  ReleaseLockOnlyAtBootTime (&mVariableModuleGlobal->VariableGlobal.VariableServicesLock);
+  return Status;
+}
+
+
 /**
   Notification function of EVT_SIGNAL_VIRTUAL_ADDRESS_CHANGE.
 
@@ -246,6 +419,10 @@ VariableClassAddressChangeEvent (
   EfiConvertPointer (0x0, (VOID **) &mVariableModuleGlobal->VariableGlobal.NonVolatileVariableBase);
   EfiConvertPointer (0x0, (VOID **) &mVariableModuleGlobal->VariableGlobal.VolatileVariableBase);
   EfiConvertPointer (0x0, (VOID **) &mVariableModuleGlobal->VariableGlobal.HobVariableBase);
+  EfiConvertPointer (0x0, (VOID **) &mVariableModuleGlobal->VolatileVariableIndex.Buckets);
+  EfiConvertPointer (0x0, (VOID **) &mVariableModuleGlobal->VolatileVariableIndex.Entries);
+  EfiConvertPointer (0x0, (VOID **) &mVariableModuleGlobal->NvVariableIndex.Buckets);
+  EfiConvertPointer (0x0, (VOID **) &mVariableModuleGlobal->NvVariableIndex.Entries);
   EfiConvertPointer (0x0, (VOID **) &mVariableModuleGlobal);
   EfiConvertPointer (0x0, (VOID **) &mNvVariableCache);
   EfiConvertPointer (0x0, (VOID **) &mNvFvHeaderCache);
@@ -301,6 +478,7 @@ OnReadyToBoot (
     } else {
       gBS->InstallConfigurationTable (&gEfiVariableGuid, gVariableInfo);
     }
+    gBS->InstallConfigurationTable (&gEdkiiVariableReclaimStatisticsGuid, &mVariableModuleGlobal->ReclaimStatistics);
   }
 
   gBS->CloseEvent (Event);
@@ -508,6 +686,20 @@ VariableServiceInitialize (
                   );
   ASSERT_EFI_ERROR (Status);
 
+  //
+  // In emulated non-volatile variable mode there is no flash copy of the store
+  // to roll a failed batch back to, so batches are not supported.
+  //
+  if (!mVariableModuleGlobal->VariableGlobal.EmuNvMode) {
+    Status = gBS->InstallMultipleProtocolInterfaces (
+                    &mHandle,
+                    &gEdkiiVariableBatchProtocolGuid,
+                    &mVariableBatch,
+                    NULL
+                    );
+    ASSERT_EFI_ERROR (Status);
+  }
+
   SystemTable->RuntimeServices->GetVariable         = VariableServiceGetVariable;
   SystemTable->RuntimeServices->GetNextVariableName = VariableServiceGetNextVariableName;
   SystemTable->RuntimeServices->SetVariable         = VariableServiceSetVariable;
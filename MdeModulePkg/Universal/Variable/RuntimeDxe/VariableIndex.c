@@ -0,0 +1,324 @@
+/** @file
+  Functions to maintain a hashed lookup index of the variable stores, so that
+  a variable can be found without walking the whole store.
+
+  The index records the offset of every variable header in a store, hashed by
+  variable name and vendor GUID. A variable is only ever added to a store by
+  appending it after the last variable, and the variables only move when the
+  store is reclaimed, so the index is updated on append and rebuilt after a
+  reclaim. State changes of the variables do not change the index, the state
+  is checked when the variables of a hash bucket are compared.
+
+  Caution: This module requires additional review when modified.
+  This driver will have external input - variable data. They may be input in SMM mode.
+  This external input must be validated carefully to avoid security issue like
+  buffer overflow, integer overflow.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "VariableParsing.h"
+#include "VariableIndex.h"
+
+/**
+  Calculate the hash of a variable name and vendor GUID.
+
+  Only the characters before the first null character are hashed, so the name
+  of a variable header and the name given by the caller hash to the same value
+  whenever they are compared equal.
+
+  @param[in] VariableName   Pointer to the variable name.
+  @param[in] NameSize       Maximum size of the variable name in bytes.
+  @param[in] VendorGuid     Pointer to the vendor GUID.
+
+  @return The number of the hash bucket.
+
+**/
+UINT32
+GetVariableIndexBucket (
+  IN CHAR16    *VariableName,
+  IN UINTN     NameSize,
+  IN EFI_GUID  *VendorGuid
+  )
+{
+  UINT32  Hash;
+  UINT8   *Byte;
+  UINTN   Index;
+  CHAR16  Char;
+
+  //
+  // 32-bit FNV-1a over the vendor GUID and the variable name.
+  //
+  Hash = 0x811C9DC5;
+  Byte = (UINT8 *) VendorGuid;
+  for (Index = 0; Index < sizeof (EFI_GUID); Index++) {
+    Hash = (Hash ^ Byte[Index]) * 0x01000193;
+  }
+  for (Index = 0; Index < NameSize / sizeof (CHAR16); Index++) {
+    Char = ReadUnaligned16 ((UINT16 *) &VariableName[Index]);
+    if (Char == 0) {
+      break;
+    }
+    Hash = (Hash ^ (Char & 0xFF)) * 0x01000193;
+    Hash = (Hash ^ (Char >> 8)) * 0x01000193;
+  }
+
+  return Hash & (VARIABLE_INDEX_BUCKET_COUNT - 1);
+}
+
+/**
+  Add a variable that has been appended to a variable store to the lookup
+  index of the store.
+
+  @param[in, out] VariableIndex         Pointer to the index of the store.
+  @param[in]      VariableStoreHeader   Pointer to the variable store header.
+  @param[in]      Offset                Offset of the variable header in the store.
+  @param[in]      AuthFormat            TRUE indicates authenticated variables are used.
+                                        FALSE indicates authenticated variables are not used.
+
+**/
+VOID
+AddVariableToStoreIndex (
+  IN OUT VARIABLE_STORE_INDEX   *VariableIndex,
+  IN     VARIABLE_STORE_HEADER  *VariableStoreHeader,
+  IN     UINTN                  Offset,
+  IN     BOOLEAN                AuthFormat
+  )
+{
+  VARIABLE_HEADER  *Variable;
+  UINT32           Bucket;
+
+  if ((VariableIndex->Buckets == NULL) || !VariableIndex->Valid) {
+    return;
+  }
+
+  if (VariableIndex->EntryCount >= VariableIndex->MaxEntryCount) {
+    //
+    // Can not happen with a well formed store. Stop using the index
+    // until it is rebuilt.
+    //
+    VariableIndex->Valid = FALSE;
+    return;
+  }
+
+  Variable = (VARIABLE_HEADER *) ((UINTN) VariableStoreHeader + Offset);
+  Bucket   = GetVariableIndexBucket (
+               GetVariableNamePtr (Variable, AuthFormat),
+               NameSizeOfVariable (Variable, AuthFormat),
+               GetVendorGuidPtr (Variable, AuthFormat)
+               );
+
+  VariableIndex->Entries[VariableIndex->EntryCount].Offset = (UINT32) ((UINTN) Variable - (UINTN) GetStartPointer (VariableStoreHeader));
+  VariableIndex->Entries[VariableIndex->EntryCount].Next   = VariableIndex->Buckets[Bucket];
+  VariableIndex->EntryCount++;
+  VariableIndex->Buckets[Bucket] = VariableIndex->EntryCount;
+}
+
+/**
+  Rebuild the lookup index of a variable store, after the variables in the
+  store have been moved by a reclaim or re-parsed.
+
+  @param[in, out] VariableIndex         Pointer to the index of the store.
+  @param[in]      VariableStoreHeader   Pointer to the variable store header.
+  @param[in]      AuthFormat            TRUE indicates authenticated variables are used.
+                                        FALSE indicates authenticated variables are not used.
+
+**/
+VOID
+RebuildVariableStoreIndex (
+  IN OUT VARIABLE_STORE_INDEX   *VariableIndex,
+  IN     VARIABLE_STORE_HEADER  *VariableStoreHeader,
+  IN     BOOLEAN                AuthFormat
+  )
+{
+  VARIABLE_HEADER  *Variable;
+  VARIABLE_HEADER  *EndPtr;
+
+  if (VariableIndex->Buckets == NULL) {
+    return;
+  }
+
+  ZeroMem (VariableIndex->Buckets, sizeof (UINT32) * VARIABLE_INDEX_BUCKET_COUNT);
+  VariableIndex->EntryCount = 0;
+  VariableIndex->Valid      = TRUE;
+
+  Variable = GetStartPointer (VariableStoreHeader);
+  EndPtr   = GetEndPointer (VariableStoreHeader);
+  while (IsValidVariableHeader (Variable, EndPtr) && VariableIndex->Valid) {
+    AddVariableToStoreIndex (
+      VariableIndex,
+      VariableStoreHeader,
+      (UINTN) Variable - (UINTN) VariableStoreHeader,
+      AuthFormat
+      );
+    Variable = GetNextVariablePtr (Variable, AuthFormat);
+  }
+}
+
+/**
+  Allocate the lookup index of a variable store and build it from the
+  variables currently in the store.
+
+  The index is sized for the largest number of variables the store can hold,
+  so it never needs to grow afterwards. If it can not be allocated, the store
+  is simply searched without index.
+
+  @param[in, out] VariableIndex         Pointer to the index of the store.
+  @param[in]      VariableStoreHeader   Pointer to the variable store header.
+  @param[in]      AuthFormat            TRUE indicates authenticated variables are used.
+                                        FALSE indicates authenticated variables are not used.
+
+**/
+VOID
+InitVariableStoreIndex (
+  IN OUT VARIABLE_STORE_INDEX   *VariableIndex,
+  IN     VARIABLE_STORE_HEADER  *VariableStoreHeader,
+  IN     BOOLEAN                AuthFormat
+  )
+{
+  UINTN  MaxEntryCount;
+
+  ZeroMem (VariableIndex, sizeof (VARIABLE_STORE_INDEX));
+
+  //
+  // Every variable takes at least the size of a variable header.
+  //
+  MaxEntryCount = (VariableStoreHeader->Size - sizeof (VARIABLE_STORE_HEADER)) / sizeof (VARIABLE_HEADER);
+
+  VariableIndex->Buckets = AllocateRuntimeZeroPool (sizeof (UINT32) * VARIABLE_INDEX_BUCKET_COUNT);
+  VariableIndex->Entries = AllocateRuntimePool (sizeof (VARIABLE_INDEX_ENTRY) * MaxEntryCount);
+  if ((VariableIndex->Buckets == NULL) || (VariableIndex->Entries == NULL)) {
+    if (VariableIndex->Buckets != NULL) {
+      FreePool (VariableIndex->Buckets);
+    }
+    if (VariableIndex->Entries != NULL) {
+      FreePool (VariableIndex->Entries);
+    }
+    ZeroMem (VariableIndex, sizeof (VARIABLE_STORE_INDEX));
+    return;
+  }
+  VariableIndex->MaxEntryCount = (UINT32) MaxEntryCount;
+
+  RebuildVariableStoreIndex (VariableIndex, VariableStoreHeader, AuthFormat);
+}
+
+/**
+  Check whether a variable of the lookup index matches the variable searched for,
+  with the same rules as FindVariableEx().
+
+  @param[in]  Variable        Pointer to the variable header.
+  @param[in]  VariableName    Name of the variable to be found
+  @param[in]  VendorGuid      Vendor GUID to be found.
+  @param[in]  IgnoreRtCheck   Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                              check at runtime when searching variable.
+  @param[in]  AuthFormat      TRUE indicates authenticated variables are used.
+                              FALSE indicates authenticated variables are not used.
+
+  @retval TRUE                The variable matches.
+  @retval FALSE               The variable does not match.
+
+**/
+BOOLEAN
+IsIndexedVariableMatch (
+  IN VARIABLE_HEADER  *Variable,
+  IN CHAR16           *VariableName,
+  IN EFI_GUID         *VendorGuid,
+  IN BOOLEAN          IgnoreRtCheck,
+  IN BOOLEAN          AuthFormat
+  )
+{
+  if (Variable->State != VAR_ADDED &&
+      Variable->State != (VAR_IN_DELETED_TRANSITION & VAR_ADDED)) {
+    return FALSE;
+  }
+
+  if (!IgnoreRtCheck && AtRuntime () && ((Variable->Attributes & EFI_VARIABLE_RUNTIME_ACCESS) == 0)) {
+    return FALSE;
+  }
+
+  if (!CompareGuid (VendorGuid, GetVendorGuidPtr (Variable, AuthFormat))) {
+    return FALSE;
+  }
+
+  ASSERT (NameSizeOfVariable (Variable, AuthFormat) != 0);
+  return (BOOLEAN) (CompareMem (VariableName, GetVariableNamePtr (Variable, AuthFormat), NameSizeOfVariable (Variable, AuthFormat)) == 0);
+}
+
+/**
+  Find the variable in the specified variable store through its lookup index.
+
+  The result is the same as the one of FindVariableEx() on the whole store.
+
+  @param[in]       VariableIndex       Pointer to the index of the store.
+  @param[in]       VariableName        Name of the variable to be found
+  @param[in]       VendorGuid          Vendor GUID to be found.
+  @param[in]       IgnoreRtCheck       Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                       check at runtime when searching variable.
+  @param[in, out]  PtrTrack            Variable Track Pointer structure that contains Variable Information.
+  @param[in]       AuthFormat          TRUE indicates authenticated variables are used.
+                                       FALSE indicates authenticated variables are not used.
+
+  @retval          EFI_SUCCESS         Variable found successfully
+  @retval          EFI_NOT_FOUND       Variable not found
+  @retval          EFI_UNSUPPORTED     The store has no index, or VariableName is an
+                                       empty string. FindVariableEx() must be used.
+**/
+EFI_STATUS
+FindVariableInStoreIndex (
+  IN     VARIABLE_STORE_INDEX    *VariableIndex,
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN     BOOLEAN                 IgnoreRtCheck,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN     BOOLEAN                 AuthFormat
+  )
+{
+  UINT32           Bucket;
+  UINT32           Entry;
+  VARIABLE_HEADER  *Variable;
+  VARIABLE_HEADER  *AddedVariable;
+  VARIABLE_HEADER  *InDeletedVariable;
+
+  if ((VariableIndex->Buckets == NULL) || !VariableIndex->Valid || (VariableName[0] == 0)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // The variables of a bucket are chained from the last added one. Walking
+  // the store returns the first ADDED variable together with the last
+  // IN_DELETED_TRANSITION one before it, or the last IN_DELETED_TRANSITION
+  // variable if there is no ADDED one. Pick the same ones by address.
+  //
+  Bucket        = GetVariableIndexBucket (VariableName, StrSize (VariableName), VendorGuid);
+  AddedVariable = NULL;
+  for (Entry = VariableIndex->Buckets[Bucket]; Entry != 0; Entry = VariableIndex->Entries[Entry - 1].Next) {
+    Variable = (VARIABLE_HEADER *) ((UINTN) PtrTrack->StartPtr + VariableIndex->Entries[Entry - 1].Offset);
+    if ((Variable->State == VAR_ADDED) &&
+        ((AddedVariable == NULL) || (Variable < AddedVariable)) &&
+        IsIndexedVariableMatch (Variable, VariableName, VendorGuid, IgnoreRtCheck, AuthFormat)) {
+      AddedVariable = Variable;
+    }
+  }
+
+  InDeletedVariable = NULL;
+  for (Entry = VariableIndex->Buckets[Bucket]; Entry != 0; Entry = VariableIndex->Entries[Entry - 1].Next) {
+    Variable = (VARIABLE_HEADER *) ((UINTN) PtrTrack->StartPtr + VariableIndex->Entries[Entry - 1].Offset);
+    if ((Variable->State == (VAR_IN_DELETED_TRANSITION & VAR_ADDED)) &&
+        ((AddedVariable == NULL) || (Variable < AddedVariable)) &&
+        ((InDeletedVariable == NULL) || (Variable > InDeletedVariable)) &&
+        IsIndexedVariableMatch (Variable, VariableName, VendorGuid, IgnoreRtCheck, AuthFormat)) {
+      InDeletedVariable = Variable;
+    }
+  }
+
+  if (AddedVariable != NULL) {
+    PtrTrack->CurrPtr                = AddedVariable;
+    PtrTrack->InDeletedTransitionPtr = InDeletedVariable;
+    return EFI_SUCCESS;
+  }
+
+  PtrTrack->CurrPtr                = InDeletedVariable;
+  PtrTrack->InDeletedTransitionPtr = NULL;
+  return (PtrTrack->CurrPtr == NULL) ? EFI_NOT_FOUND : EFI_SUCCESS;
+}
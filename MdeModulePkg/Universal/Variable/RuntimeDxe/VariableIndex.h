@@ -0,0 +1,100 @@
+/** @file
+  The hashed lookup index of the variable stores shared by the DXE_RUNTIME
+  variable module and the DXE_SMM variable module.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _VARIABLE_INDEX_H_
+#define _VARIABLE_INDEX_H_
+
+#include "Variable.h"
+
+/**
+  Allocate the lookup index of a variable store and build it from the
+  variables currently in the store.
+
+  The index is sized for the largest number of variables the store can hold,
+  so it never needs to grow afterwards. If it can not be allocated, the store
+  is simply searched without index.
+
+  @param[in, out] VariableIndex         Pointer to the index of the store.
+  @param[in]      VariableStoreHeader   Pointer to the variable store header.
+  @param[in]      AuthFormat            TRUE indicates authenticated variables are used.
+                                        FALSE indicates authenticated variables are not used.
+
+**/
+VOID
+InitVariableStoreIndex (
+  IN OUT VARIABLE_STORE_INDEX   *VariableIndex,
+  IN     VARIABLE_STORE_HEADER  *VariableStoreHeader,
+  IN     BOOLEAN                AuthFormat
+  );
+
+/**
+  Rebuild the lookup index of a variable store, after the variables in the
+  store have been moved by a reclaim or re-parsed.
+
+  @param[in, out] VariableIndex         Pointer to the index of the store.
+  @param[in]      VariableStoreHeader   Pointer to the variable store header.
+  @param[in]      AuthFormat            TRUE indicates authenticated variables are used.
+                                        FALSE indicates authenticated variables are not used.
+
+**/
+VOID
+RebuildVariableStoreIndex (
+  IN OUT VARIABLE_STORE_INDEX   *VariableIndex,
+  IN     VARIABLE_STORE_HEADER  *VariableStoreHeader,
+  IN     BOOLEAN                AuthFormat
+  );
+
+/**
+  Add a variable that has been appended to a variable store to the lookup
+  index of the store.
+
+  @param[in, out] VariableIndex         Pointer to the index of the store.
+  @param[in]      VariableStoreHeader   Pointer to the variable store header.
+  @param[in]      Offset                Offset of the variable header in the store.
+  @param[in]      AuthFormat            TRUE indicates authenticated variables are used.
+                                        FALSE indicates authenticated variables are not used.
+
+**/
+VOID
+AddVariableToStoreIndex (
+  IN OUT VARIABLE_STORE_INDEX   *VariableIndex,
+  IN     VARIABLE_STORE_HEADER  *VariableStoreHeader,
+  IN     UINTN                  Offset,
+  IN     BOOLEAN                AuthFormat
+  );
+
+/**
+  Find the variable in the specified variable store through its lookup index.
+
+  The result is the same as the one of FindVariableEx() on the whole store.
+
+  @param[in]       VariableIndex       Pointer to the index of the store.
+  @param[in]       VariableName        Name of the variable to be found
+  @param[in]       VendorGuid          Vendor GUID to be found.
+  @param[in]       IgnoreRtCheck       Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                       check at runtime when searching variable.
+  @param[in, out]  PtrTrack            Variable Track Pointer structure that contains Variable Information.
+  @param[in]       AuthFormat          TRUE indicates authenticated variables are used.
+                                       FALSE indicates authenticated variables are not used.
+
+  @retval          EFI_SUCCESS         Variable found successfully
+  @retval          EFI_NOT_FOUND       Variable not found
+  @retval          EFI_UNSUPPORTED     The store has no index, or VariableName is an
+                                       empty string. FindVariableEx() must be used.
+**/
+EFI_STATUS
+FindVariableInStoreIndex (
+  IN     VARIABLE_STORE_INDEX    *VariableIndex,
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN     BOOLEAN                 IgnoreRtCheck,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN     BOOLEAN                 AuthFormat
+  );
+
+#endif
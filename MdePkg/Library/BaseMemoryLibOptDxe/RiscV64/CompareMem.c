@@ -0,0 +1,84 @@
+/** @file
+  Implementation of the InternalMemCompareMem routine for RISC-V.
+
+  When both buffers share the same alignment the common prefix is skipped a
+  64-bit word at a time. The first mismatching word is then re-examined
+  byte by byte to produce the same result as a byte-wise comparison.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "../MemLibInternals.h"
+
+/**
+  Compares two memory buffers of a given length.
+
+  @param  DestinationBuffer The first memory buffer.
+  @param  SourceBuffer      The second memory buffer.
+  @param  Length            The length of DestinationBuffer and SourceBuffer memory
+                            regions to compare. Must be non-zero.
+
+  @return 0                 All Length bytes of the two buffers are identical.
+  @retval Non-zero          The first mismatched byte in SourceBuffer subtracted from the first
+                            mismatched byte in DestinationBuffer.
+
+**/
+INTN
+EFIAPI
+InternalMemCompareMem (
+  IN      CONST VOID                *DestinationBuffer,
+  IN      CONST VOID                *SourceBuffer,
+  IN      UINTN                     Length
+  )
+{
+  CONST UINT8                       *Destination8;
+  CONST UINT8                       *Source8;
+  CONST UINT64                      *Destination64;
+  CONST UINT64                      *Source64;
+
+  Destination8 = (CONST UINT8 *)DestinationBuffer;
+  Source8      = (CONST UINT8 *)SourceBuffer;
+
+  if (((((UINTN)Destination8 ^ (UINTN)Source8) & 0x7) == 0) && (Length >= 8)) {
+    while (((UINTN)Destination8 & 0x7) != 0) {
+      if (*Destination8 != *Source8) {
+        return (INTN)*Destination8 - (INTN)*Source8;
+      }
+      Destination8++;
+      Source8++;
+      Length--;
+    }
+
+    Destination64 = (CONST UINT64 *)Destination8;
+    Source64      = (CONST UINT64 *)Source8;
+
+    while (Length >= 32) {
+      if ((Destination64[0] != Source64[0]) || (Destination64[1] != Source64[1]) ||
+          (Destination64[2] != Source64[2]) || (Destination64[3] != Source64[3])) {
+        break;
+      }
+      Destination64 += 4;
+      Source64      += 4;
+      Length        -= 32;
+    }
+
+    while ((Length >= 8) && (*Destination64 == *Source64)) {
+      Destination64++;
+      Source64++;
+      Length -= 8;
+    }
+
+    Destination8 = (CONST UINT8 *)Destination64;
+    Source8      = (CONST UINT8 *)Source64;
+  }
+
+  while (Length-- != 0) {
+    if (*Destination8 != *Source8) {
+      return (INTN)*Destination8 - (INTN)*Source8;
+    }
+    Destination8++;
+    Source8++;
+  }
+  return 0;
+}
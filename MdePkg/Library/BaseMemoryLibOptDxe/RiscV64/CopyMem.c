@@ -0,0 +1,190 @@
+/** @file
+  Implementation of the InternalMemCopyMem routine for RISC-V.
+
+  RISC-V cores are not required to support misaligned loads and stores in
+  hardware, and where they are emulated by M-mode firmware they are orders
+  of magnitude slower than aligned accesses. The copy therefore only moves
+  64-bit words when source and destination share the same alignment, and
+  moves 64 bytes per loop iteration to keep the load/store pipeline busy.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "../MemLibInternals.h"
+
+/**
+  Copy Length bytes from Source to Destination, lowest address first.
+
+  @param  Destination8  The target of the copy request.
+  @param  Source8       The place to copy from.
+  @param  Length        The number of bytes to copy.
+
+**/
+STATIC
+VOID
+InternalMemCopyForward (
+  OUT     volatile UINT8            *Destination8,
+  IN      CONST UINT8               *Source8,
+  IN      UINTN                     Length
+  )
+{
+  volatile UINT64                   *Destination64;
+  CONST UINT64                      *Source64;
+  UINT64                            Word0;
+  UINT64                            Word1;
+  UINT64                            Word2;
+  UINT64                            Word3;
+
+  if (((((UINTN)Destination8 ^ (UINTN)Source8) & 0x7) == 0) && (Length >= 8)) {
+    while (((UINTN)Destination8 & 0x7) != 0) {
+      *(Destination8++) = *(Source8++);
+      Length--;
+    }
+
+    Destination64 = (volatile UINT64 *)Destination8;
+    Source64      = (CONST UINT64 *)Source8;
+
+    //
+    // Loads are issued ahead of the stores so that an overlapping copy with
+    // Source above Destination never reads data it has already overwritten.
+    //
+    while (Length >= 64) {
+      Word0 = Source64[0];
+      Word1 = Source64[1];
+      Word2 = Source64[2];
+      Word3 = Source64[3];
+      Destination64[0] = Word0;
+      Destination64[1] = Word1;
+      Destination64[2] = Word2;
+      Destination64[3] = Word3;
+      Word0 = Source64[4];
+      Word1 = Source64[5];
+      Word2 = Source64[6];
+      Word3 = Source64[7];
+      Destination64[4] = Word0;
+      Destination64[5] = Word1;
+      Destination64[6] = Word2;
+      Destination64[7] = Word3;
+      Destination64 += 8;
+      Source64      += 8;
+      Length        -= 64;
+    }
+
+    while (Length >= 8) {
+      *(Destination64++) = *(Source64++);
+      Length -= 8;
+    }
+
+    Destination8 = (volatile UINT8 *)Destination64;
+    Source8      = (CONST UINT8 *)Source64;
+  }
+
+  while (Length-- != 0) {
+    *(Destination8++) = *(Source8++);
+  }
+}
+
+/**
+  Copy Length bytes from Source to Destination, highest address first.
+
+  @param  Destination8  The target of the copy request.
+  @param  Source8       The place to copy from.
+  @param  Length        The number of bytes to copy.
+
+**/
+STATIC
+VOID
+InternalMemCopyBackward (
+  OUT     volatile UINT8            *Destination8,
+  IN      CONST UINT8               *Source8,
+  IN      UINTN                     Length
+  )
+{
+  volatile UINT64                   *Destination64;
+  CONST UINT64                      *Source64;
+  UINT64                            Word0;
+  UINT64                            Word1;
+  UINT64                            Word2;
+  UINT64                            Word3;
+
+  //
+  // Work from one byte past the end of each buffer.
+  //
+  Destination8 += Length;
+  Source8      += Length;
+
+  if (((((UINTN)Destination8 ^ (UINTN)Source8) & 0x7) == 0) && (Length >= 8)) {
+    while (((UINTN)Destination8 & 0x7) != 0) {
+      *(--Destination8) = *(--Source8);
+      Length--;
+    }
+
+    Destination64 = (volatile UINT64 *)Destination8;
+    Source64      = (CONST UINT64 *)Source8;
+
+    while (Length >= 64) {
+      Destination64 -= 8;
+      Source64      -= 8;
+      Word0 = Source64[7];
+      Word1 = Source64[6];
+      Word2 = Source64[5];
+      Word3 = Source64[4];
+      Destination64[7] = Word0;
+      Destination64[6] = Word1;
+      Destination64[5] = Word2;
+      Destination64[4] = Word3;
+      Word0 = Source64[3];
+      Word1 = Source64[2];
+      Word2 = Source64[1];
+      Word3 = Source64[0];
+      Destination64[3] = Word0;
+      Destination64[2] = Word1;
+      Destination64[1] = Word2;
+      Destination64[0] = Word3;
+      Length -= 64;
+    }
+
+    while (Length >= 8) {
+      *(--Destination64) = *(--Source64);
+      Length -= 8;
+    }
+
+    Destination8 = (volatile UINT8 *)Destination64;
+    Source8      = (CONST UINT8 *)Source64;
+  }
+
+  while (Length-- != 0) {
+    *(--Destination8) = *(--Source8);
+  }
+}
+
+/**
+  Copy Length bytes from Source to Destination.
+
+  @param  DestinationBuffer The target of the copy request.
+  @param  SourceBuffer      The place to copy from.
+  @param  Length            The number of bytes to copy.
+
+  @return Destination
+
+**/
+VOID *
+EFIAPI
+InternalMemCopyMem (
+  OUT     VOID                      *DestinationBuffer,
+  IN      CONST VOID                *SourceBuffer,
+  IN      UINTN                     Length
+  )
+{
+  //
+  // A forward copy is only unsafe when Destination lies inside Source.
+  //
+  if (((UINTN)DestinationBuffer <= (UINTN)SourceBuffer) ||
+      ((UINTN)DestinationBuffer - (UINTN)SourceBuffer >= Length)) {
+    InternalMemCopyForward (DestinationBuffer, SourceBuffer, Length);
+  } else {
+    InternalMemCopyBackward (DestinationBuffer, SourceBuffer, Length);
+  }
+  return DestinationBuffer;
+}
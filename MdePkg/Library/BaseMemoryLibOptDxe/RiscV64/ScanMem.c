@@ -0,0 +1,224 @@
+/** @file
+  Implementation of the InternalMemScanMem and InternalMemIsZeroBuffer
+  routines for RISC-V.
+
+  ScanMem8 tests eight bytes per iteration using the classic "has zero
+  byte" word trick, since the base RV64 ISA targeted by the tools_def flags
+  does not include the Zbb orc.b instruction.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "../MemLibInternals.h"
+
+#define BYTE_REPEAT_MASK_LOW   0x0101010101010101ULL
+#define BYTE_REPEAT_MASK_HIGH  0x8080808080808080ULL
+
+/**
+  Scans a target buffer for an 8-bit value, and returns a pointer to the
+  matching 8-bit value in the target buffer.
+
+  @param  Buffer  The pointer to the target buffer to scan.
+  @param  Length  The count of 8-bit value to scan. Must be non-zero.
+  @param  Value   The value to search for in the target buffer.
+
+  @return The pointer to the first occurrence, or NULL if not found.
+
+**/
+CONST VOID *
+EFIAPI
+InternalMemScanMem8 (
+  IN      CONST VOID                *Buffer,
+  IN      UINTN                     Length,
+  IN      UINT8                     Value
+  )
+{
+  CONST UINT8                       *Pointer8;
+  CONST UINT64                      *Pointer64;
+  UINT64                            Pattern;
+  UINT64                            Word;
+
+  Pointer8 = (CONST UINT8 *)Buffer;
+
+  if (Length >= 8) {
+    while (((UINTN)Pointer8 & 0x7) != 0) {
+      if (*Pointer8 == Value) {
+        return Pointer8;
+      }
+      Pointer8++;
+      Length--;
+    }
+
+    Pointer64 = (CONST UINT64 *)Pointer8;
+    Pattern   = MultU64x32 (BYTE_REPEAT_MASK_LOW, Value);
+    while (Length >= 8) {
+      //
+      // A byte of Word is zero exactly where the buffer holds Value.
+      //
+      Word = *Pointer64 ^ Pattern;
+      if (((Word - BYTE_REPEAT_MASK_LOW) & ~Word & BYTE_REPEAT_MASK_HIGH) != 0) {
+        break;
+      }
+      Pointer64++;
+      Length -= 8;
+    }
+    Pointer8 = (CONST UINT8 *)Pointer64;
+  }
+
+  while (Length-- != 0) {
+    if (*Pointer8 == Value) {
+      return Pointer8;
+    }
+    Pointer8++;
+  }
+  return NULL;
+}
+
+/**
+  Scans a target buffer for a 16-bit value, and returns a pointer to the
+  matching 16-bit value in the target buffer.
+
+  @param  Buffer  The pointer to the target buffer to scan.
+  @param  Length  The count of 16-bit value to scan. Must be non-zero.
+  @param  Value   The value to search for in the target buffer.
+
+  @return The pointer to the first occurrence, or NULL if not found.
+
+**/
+CONST VOID *
+EFIAPI
+InternalMemScanMem16 (
+  IN      CONST VOID                *Buffer,
+  IN      UINTN                     Length,
+  IN      UINT16                    Value
+  )
+{
+  CONST UINT16                      *Pointer;
+
+  Pointer = (CONST UINT16*)Buffer;
+  do {
+    if (*Pointer == Value) {
+      return Pointer;
+    }
+    ++Pointer;
+  } while (--Length != 0);
+  return NULL;
+}
+
+/**
+  Scans a target buffer for a 32-bit value, and returns a pointer to the
+  matching 32-bit value in the target buffer.
+
+  @param  Buffer  The pointer to the target buffer to scan.
+  @param  Length  The count of 32-bit value to scan. Must be non-zero.
+  @param  Value   The value to search for in the target buffer.
+
+  @return The pointer to the first occurrence, or NULL if not found.
+
+**/
+CONST VOID *
+EFIAPI
+InternalMemScanMem32 (
+  IN      CONST VOID                *Buffer,
+  IN      UINTN                     Length,
+  IN      UINT32                    Value
+  )
+{
+  CONST UINT32                      *Pointer;
+
+  Pointer = (CONST UINT32*)Buffer;
+  do {
+    if (*Pointer == Value) {
+      return Pointer;
+    }
+    ++Pointer;
+  } while (--Length != 0);
+  return NULL;
+}
+
+/**
+  Scans a target buffer for a 64-bit value, and returns a pointer to the
+  matching 64-bit value in the target buffer.
+
+  @param  Buffer  The pointer to the target buffer to scan.
+  @param  Length  The count of 64-bit value to scan. Must be non-zero.
+  @param  Value   The value to search for in the target buffer.
+
+  @return The pointer to the first occurrence, or NULL if not found.
+
+**/
+CONST VOID *
+EFIAPI
+InternalMemScanMem64 (
+  IN      CONST VOID                *Buffer,
+  IN      UINTN                     Length,
+  IN      UINT64                    Value
+  )
+{
+  CONST UINT64                      *Pointer;
+
+  Pointer = (CONST UINT64*)Buffer;
+  do {
+    if (*Pointer == Value) {
+      return Pointer;
+    }
+    ++Pointer;
+  } while (--Length != 0);
+  return NULL;
+}
+
+/**
+  Checks whether the contents of a buffer are all zeros.
+
+  @param  Buffer  The pointer to the buffer to be checked.
+  @param  Length  The size of the buffer (in bytes) to be checked.
+
+  @retval TRUE    Contents of the buffer are all zeros.
+  @retval FALSE   Contents of the buffer are not all zeros.
+
+**/
+BOOLEAN
+EFIAPI
+InternalMemIsZeroBuffer (
+  IN CONST VOID  *Buffer,
+  IN UINTN       Length
+  )
+{
+  CONST UINT8                       *Pointer8;
+  CONST UINT64                      *Pointer64;
+
+  Pointer8 = (CONST UINT8 *)Buffer;
+
+  if (Length >= 8) {
+    while (((UINTN)Pointer8 & 0x7) != 0) {
+      if (*(Pointer8++) != 0) {
+        return FALSE;
+      }
+      Length--;
+    }
+
+    Pointer64 = (CONST UINT64 *)Pointer8;
+    while (Length >= 32) {
+      if ((Pointer64[0] | Pointer64[1] | Pointer64[2] | Pointer64[3]) != 0) {
+        return FALSE;
+      }
+      Pointer64 += 4;
+      Length    -= 32;
+    }
+    while (Length >= 8) {
+      if (*(Pointer64++) != 0) {
+        return FALSE;
+      }
+      Length -= 8;
+    }
+    Pointer8 = (CONST UINT8 *)Pointer64;
+  }
+
+  while (Length-- != 0) {
+    if (*(Pointer8++) != 0) {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
@@ -0,0 +1,217 @@
+/** @file
+  Implementation of the InternalMemSetMem and InternalMemZeroMem families
+  for RISC-V.
+
+  The fill value is replicated into a 64-bit pattern and stored with aligned
+  64-bit stores, 64 bytes per loop iteration. Only the unaligned head and
+  the tail of the buffer are written with narrower stores.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "../MemLibInternals.h"
+
+/**
+  Fill Count 64-bit words starting at the 64-bit aligned Buffer with Pattern.
+
+  @param  Buffer   The memory to set. Must be 64-bit aligned.
+  @param  Count    The number of 64-bit words to set.
+  @param  Pattern  The 64-bit value to store.
+
+  @return The first 64-bit word following the filled region.
+
+**/
+STATIC
+volatile UINT64 *
+InternalMemFill64 (
+  OUT     volatile UINT64           *Buffer,
+  IN      UINTN                     Count,
+  IN      UINT64                    Pattern
+  )
+{
+  while (Count >= 8) {
+    Buffer[0] = Pattern;
+    Buffer[1] = Pattern;
+    Buffer[2] = Pattern;
+    Buffer[3] = Pattern;
+    Buffer[4] = Pattern;
+    Buffer[5] = Pattern;
+    Buffer[6] = Pattern;
+    Buffer[7] = Pattern;
+    Buffer += 8;
+    Count  -= 8;
+  }
+
+  while (Count-- != 0) {
+    *(Buffer++) = Pattern;
+  }
+  return Buffer;
+}
+
+/**
+  Set Buffer to Value for Size bytes.
+
+  @param  Buffer   The memory to set.
+  @param  Length   The number of bytes to set.
+  @param  Value    The value of the set operation.
+
+  @return Buffer
+
+**/
+VOID *
+EFIAPI
+InternalMemSetMem (
+  OUT     VOID                      *Buffer,
+  IN      UINTN                     Length,
+  IN      UINT8                     Value
+  )
+{
+  volatile UINT8                    *Pointer8;
+
+  Pointer8 = (UINT8 *)Buffer;
+
+  if (Length >= 8) {
+    while (((UINTN)Pointer8 & 0x7) != 0) {
+      *(Pointer8++) = Value;
+      Length--;
+    }
+
+    Pointer8 = (volatile UINT8 *)InternalMemFill64 (
+                                   (volatile UINT64 *)Pointer8,
+                                   Length / sizeof (UINT64),
+                                   MultU64x32 (0x0101010101010101ULL, Value)
+                                   );
+    Length &= 0x7;
+  }
+
+  while (Length-- != 0) {
+    *(Pointer8++) = Value;
+  }
+  return Buffer;
+}
+
+/**
+  Fills a target buffer with a 16-bit value, and returns the target buffer.
+
+  @param  Buffer  The pointer to the target buffer to fill.
+  @param  Length  The count of 16-bit value to fill.
+  @param  Value   The value with which to fill Length bytes of Buffer.
+
+  @return Buffer
+
+**/
+VOID *
+EFIAPI
+InternalMemSetMem16 (
+  OUT     VOID                      *Buffer,
+  IN      UINTN                     Length,
+  IN      UINT16                    Value
+  )
+{
+  volatile UINT16                   *Pointer16;
+
+  Pointer16 = (UINT16 *)Buffer;
+
+  if (Length >= 4) {
+    while (((UINTN)Pointer16 & 0x7) != 0) {
+      *(Pointer16++) = Value;
+      Length--;
+    }
+
+    Pointer16 = (volatile UINT16 *)InternalMemFill64 (
+                                     (volatile UINT64 *)Pointer16,
+                                     Length / 4,
+                                     MultU64x32 (0x0001000100010001ULL, Value)
+                                     );
+    Length &= 0x3;
+  }
+
+  while (Length-- != 0) {
+    *(Pointer16++) = Value;
+  }
+  return Buffer;
+}
+
+/**
+  Fills a target buffer with a 32-bit value, and returns the target buffer.
+
+  @param  Buffer  The pointer to the target buffer to fill.
+  @param  Length  The count of 32-bit value to fill.
+  @param  Value   The value with which to fill Length bytes of Buffer.
+
+  @return Buffer
+
+**/
+VOID *
+EFIAPI
+InternalMemSetMem32 (
+  OUT     VOID                      *Buffer,
+  IN      UINTN                     Length,
+  IN      UINT32                    Value
+  )
+{
+  volatile UINT32                   *Pointer32;
+
+  Pointer32 = (UINT32 *)Buffer;
+
+  if (Length >= 2) {
+    if (((UINTN)Pointer32 & 0x7) != 0) {
+      *(Pointer32++) = Value;
+      Length--;
+    }
+
+    Pointer32 = (volatile UINT32 *)InternalMemFill64 (
+                                     (volatile UINT64 *)Pointer32,
+                                     Length / 2,
+                                     LShiftU64 (Value, 32) | Value
+                                     );
+    Length &= 0x1;
+  }
+
+  if (Length != 0) {
+    *Pointer32 = Value;
+  }
+  return Buffer;
+}
+
+/**
+  Fills a target buffer with a 64-bit value, and returns the target buffer.
+
+  @param  Buffer  The pointer to the target buffer to fill.
+  @param  Length  The count of 64-bit value to fill.
+  @param  Value   The value with which to fill Length bytes of Buffer.
+
+  @return Buffer
+
+**/
+VOID *
+EFIAPI
+InternalMemSetMem64 (
+  OUT     VOID                      *Buffer,
+  IN      UINTN                     Length,
+  IN      UINT64                    Value
+  )
+{
+  InternalMemFill64 ((volatile UINT64 *)Buffer, Length, Value);
+  return Buffer;
+}
+
+/**
+  Set Buffer to 0 for Size bytes.
+
+  @param  Buffer The memory to set.
+  @param  Length The number of bytes to set
+
+  @return Buffer
+
+**/
+VOID *
+EFIAPI
+InternalMemZeroMem (
+  OUT     VOID                      *Buffer,
+  IN      UINTN                     Length
+  )
+{
+  return InternalMemSetMem (Buffer, Length, 0);
+}